@@ -231,6 +231,34 @@ int sensord_connect(sensor_t sensor);
  */
 bool sensord_disconnect(int handle);
 
+/**
+ * @brief Merge the events of connected sensors into one stream ordered by timestamp.
+ *        The members keep their own interval, attributes and start/stop state,
+ *        but their events are delivered to the group callback until it is disconnected.
+ *        A sample is held until the other members report newer ones, at most reorder_window.
+ *
+ * @param[in] handles the handles of connected sensors, each sensor at most once.
+ * @param[in] count the count of handles, at most 16.
+ * @param[in] reorder_window the longest time to hold a sample for reordering, in milliseconds.
+ * @param[in] cb a callback called for every event, with the sensor it came from.
+ * @param[in] user_data the data passed to the callback.
+ * @return a handle of the group on success, otherwise a negative error value
+ * @retval -EINVAL Invalid parameter
+ * @retval -EBUSY a sensor is already in another group
+ * @retval -EACCES a listener was connected by another process
+ * @retval -EIO Input/Output error
+ */
+int sensord_connect_group(const int *handles, int count, unsigned int reorder_window,
+		sensor_cb_t cb, void *user_data);
+
+/**
+ * @brief Disconnect a group, its members deliver to their own callbacks again.
+ *
+ * @param[in] group_handle a handle returned by sensord_connect_group.
+ * @return 0 on success, otherwise a negative error value
+ */
+int sensord_disconnect_group(int group_handle);
+
 /**
  * @brief Register a callback with a connected sensor for a given event_type. This callback will be called when a given event occurs in a connected sensor.
  *
@@ -476,6 +504,31 @@ int sensord_set_attribute_int(sensor_t sensor, int attribute, int value);
  */
 int sensord_get_attribute_int(sensor_t sensor, int attribute, int *value);
 
+/**
+ * @brief Get the statistics of sensord
+ *
+ * @param[in] type the type of statistics, one of sensord_stats_e
+ * @param[out] stats null-terminated text, the caller should explicitly free this value
+ * @param[out] len the length of stats
+ * @return 0 on success, otherwise a negative error value
+ * @retval 0 Successful
+ * @retval -EINVAL Invalid parameter
+ * @retval -EIO Input/Output error
+ */
+int sensord_get_stats(int type, char **stats, int *len);
+
+/**
+ * @brief Set CPU affinity, nice value and scheduling policy of the event reader thread
+ *        The SENSOR_READER_THREAD_POLICY environment variable is applied in the same format on start.
+ *
+ * @param[in] policy e.g. "cpus=2-3;nice=-5;scheduler=fifo;priority=10"
+ * @return 0 on success, otherwise a negative error value
+ * @retval 0 Successful
+ * @retval -EINVAL Invalid parameter
+ * @retval -EIO Input/Output error
+ */
+int sensord_set_reader_thread_policy(const char *policy);
+
 /**
  * @brief Send data to sensorhub
  *
@@ -508,6 +561,34 @@ bool sensord_get_data(int handle, unsigned int data_id, sensor_data_t* sensor_da
  */
 bool sensord_get_data_list(int handle, unsigned int data_id, sensor_data_t** sensor_data, int* count);
 
+/**
+ * @brief get the recent samples of a connected sensor within a time range
+ *
+ * @param[in] handle a handle represensting a connected sensor.
+ * @param[in] start_time the oldest timestamp to return, in microseconds.
+ * @param[in] end_time the newest timestamp to return, 0 for up to now.
+ * @param[out] sensor_data the samples ordered by timestamp, the caller should explicitly free this list.
+ * @param[out] count the count of samples contained in the list.
+ * @return 0 on success, otherwise a negative error value.
+ * @retval -ENODATA no sample in the range is kept by the server.
+ */
+int sensord_get_data_history(int handle, unsigned long long start_time, unsigned long long end_time,
+		sensor_data_t **sensor_data, int *count);
+
+/**
+ * @brief get the latest samples of several connected sensors in one request
+ *        All samples are read from the server caches at the same moment.
+ *
+ * @param[in] handles the handles representing connected sensors.
+ * @param[in] count the count of handles, at most 64.
+ * @param[out] sensor_data an array of count samples, in the order of handles.
+ *             A sensor without a readable sample leaves its entry zeroed.
+ * @return the count of sensors with a sample on success, otherwise a negative error value.
+ * @retval -EINVAL Invalid parameter
+ * @retval -EIO Input/Output error
+ */
+int sensord_get_data_snapshot(const int *handles, int count, sensor_data_t *sensor_data);
+
 /**
  * @brief flush sensor data from a connected sensor
  *
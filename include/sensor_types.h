@@ -240,9 +240,23 @@ enum sensord_attribute_e {
 	SENSORD_ATTRIBUTE_MAX_BATCH_LATENCY,
 	SENSORD_ATTRIBUTE_PASSIVE_MODE,
 	SENSORD_ATTRIBUTE_FLUSH,
+	SENSORD_ATTRIBUTE_DECIMATION,
+	SENSORD_ATTRIBUTE_QUEUE_POLICY,
+	SENSORD_ATTRIBUTE_QUEUE_SIZE,
+	SENSORD_ATTRIBUTE_DROPPED_EVENTS,
+	SENSORD_ATTRIBUTE_DELIVERY_DEADLINE,
+	SENSORD_ATTRIBUTE_REPORT_MODE,
+	SENSORD_ATTRIBUTE_ABS_THRESHOLD,
+	SENSORD_ATTRIBUTE_REL_THRESHOLD,
+	SENSORD_ATTRIBUTE_AGGREGATION,
+	SENSORD_ATTRIBUTE_AGGREGATION_WINDOW,
+	SENSORD_ATTRIBUTE_FILTER,
+	SENSORD_ATTRIBUTE_FILTER_CUTOFF,
+	SENSORD_ATTRIBUTE_CHANGE_SUBSCRIPTION,
 	// 0x50~0x80 Reserved
 };
 
+/* listeners are device oriented unless they ask for display oriented axes */
 enum sensord_axis_e {
 	SENSORD_AXIS_DEVICE_ORIENTED = 1,
 	SENSORD_AXIS_DISPLAY_ORIENTED,
@@ -256,6 +270,61 @@ enum sensord_pause_e {
 	SENSORD_PAUSE_END,
 };
 
+enum sensord_decimation_e {
+	SENSORD_DECIMATION_NONE = 0,
+	SENSORD_DECIMATION_SELECT,
+	SENSORD_DECIMATION_AVERAGE,
+};
+
+enum sensord_queue_policy_e {
+	SENSORD_QUEUE_DROP_OLDEST = 0,
+	SENSORD_QUEUE_DROP_NEWEST,
+	SENSORD_QUEUE_LATEST_ONLY,
+};
+
+/* thresholds are given in 1/1000 of the value unit (absolute)
+ * or of the last reported value (relative) */
+enum sensord_report_mode_e {
+	SENSORD_REPORT_CONTINUOUS = 0,
+	SENSORD_REPORT_ON_CHANGE,
+};
+
+/* a summary event carries the selected statistics in this order,
+ * each over all axes: values[] = { mean x, y, z, min x, y, z, ... } */
+enum sensord_aggregation_e {
+	SENSORD_AGGREGATION_NONE = 0,
+	SENSORD_AGGREGATION_MEAN = 0x1,
+	SENSORD_AGGREGATION_MIN = 0x2,
+	SENSORD_AGGREGATION_MAX = 0x4,
+	SENSORD_AGGREGATION_RMS = 0x8,
+	SENSORD_AGGREGATION_ALL = 0xF,
+};
+
+/* first order and second order(Butterworth biquad) filters, the cutoff is given in mHz */
+enum sensord_filter_e {
+	SENSORD_FILTER_NONE = 0,
+	SENSORD_FILTER_LOW_PASS,
+	SENSORD_FILTER_HIGH_PASS,
+	SENSORD_FILTER_BIQUAD_LOW_PASS,
+	SENSORD_FILTER_BIQUAD_HIGH_PASS,
+};
+
+/* attribute changes made by other listeners that a listener receives */
+enum sensord_attribute_change_e {
+	SENSORD_ATTRIBUTE_CHANGE_NONE = 0,
+	SENSORD_ATTRIBUTE_CHANGE_INT = 1,
+	SENSORD_ATTRIBUTE_CHANGE_STR = 2,
+};
+
+enum sensord_stats_e {
+	SENSORD_STATS_EVENT_LOOP = 1,
+	SENSORD_STATS_LOCK,
+	SENSORD_STATS_CLIENT_LOCK,
+	SENSORD_STATS_EVENT_COPY,
+	SENSORD_STATS_CLIENT_BUDGET,
+	SENSORD_STATS_FLIGHT_RECORDER, /* dumps the flight recorder and returns where */
+};
+
 enum poll_interval_t {
 	POLL_100HZ_MS	= 10,
 	POLL_50HZ_MS	= 20,
@@ -82,6 +82,7 @@ install -m 0644 %SOURCE2 %{buildroot}%{_unitdir}
 
 mkdir -p %{buildroot}%{_sysconfdir}/sensord
 install -m 644 conf/auto_rotation.conf   %{buildroot}/etc/sensord/auto_rotation.conf
+install -m 644 conf/sensord.conf   %{buildroot}/etc/sensord/sensord.conf
 
 %install_service multi-user.target.wants sensord.service
 %install_service sockets.target.wants sensord.socket
@@ -110,6 +111,7 @@ echo "You need to reinstall %{name}-dummy to keep using the APIs after uninstall
 %{_unitdir}/multi-user.target.wants/sensord.service
 %{_unitdir}/sockets.target.wants/sensord.socket
 %config %{_sysconfdir}/sensord/auto_rotation.conf
+%config %{_sysconfdir}/sensord/sensord.conf
 %license LICENSE.APLv2
 
 
@@ -123,6 +123,17 @@ API bool sensord_disconnect(int handle)
 	return false;
 }
 
+API int sensord_connect_group(const int *handles, int count, unsigned int reorder_window,
+		sensor_cb_t cb, void *user_data)
+{
+	return -EIO;
+}
+
+API int sensord_disconnect_group(int group_handle)
+{
+	return -EIO;
+}
+
 API bool sensord_register_event(int handle, unsigned int event_type, unsigned int interval, unsigned int max_batch_latency, sensor_cb_t cb, void *user_data)
 {
 	return false;
@@ -238,6 +249,12 @@ API bool sensord_get_data_list(int handle, unsigned int data_id, sensor_data_t**
 	return false;
 }
 
+API int sensord_get_data_history(int handle, unsigned long long start_time, unsigned long long end_time,
+		sensor_data_t **sensor_data, int *count)
+{
+	return -ENODATA;
+}
+
 API bool sensord_flush(int handle)
 {
 	return false;
@@ -253,6 +270,21 @@ API bool sensord_set_passive_mode(int handle, bool passive)
 	return false;
 }
 
+API int sensord_get_data_snapshot(const int *handles, int count, sensor_data_t *sensor_data)
+{
+	return -EIO;
+}
+
+API int sensord_get_stats(int type, char **stats, int *len)
+{
+	return OP_ERROR;
+}
+
+API int sensord_set_reader_thread_policy(const char *policy)
+{
+	return OP_ERROR;
+}
+
 /* Sensor Internal API using URI */
 API int sensord_get_default_sensor_by_uri(const char *uri, sensor_t *sensor)
 {
@@ -0,0 +1,126 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "sensor_group.h"
+
+#include <sensor_log.h>
+#include <command_types.h>
+
+using namespace sensor;
+
+sensor_group::sensor_group(ipc::event_loop *loop)
+: m_id(0)
+, m_client(NULL)
+, m_evt_channel(NULL)
+, m_handler(NULL)
+, m_loop(loop)
+{
+}
+
+sensor_group::~sensor_group()
+{
+	disconnect();
+
+	if (m_handler) {
+		m_loop->add_channel_handler_release_list(m_handler);
+		m_handler = NULL;
+	}
+
+	delete m_client;
+	m_client = NULL;
+}
+
+int sensor_group::connect(sensor_listener **members, int count, int window, ipc::channel_handler *handler)
+{
+	retvm_if(!members || count <= 0 || count > MAX_GROUP_MEMBERS, -EINVAL, "Invalid parameter");
+	retvm_if(m_evt_channel, -EINVAL, "Already connected");
+
+	m_handler = handler;
+
+	m_client = new(std::nothrow) ipc::ipc_client(SENSOR_CHANNEL_PATH);
+	retvm_if(!m_client, -ENOMEM, "Failed to allocate memory");
+
+	m_evt_channel = m_client->connect(m_handler, m_loop, false);
+	retvm_if(!m_evt_channel, -EIO, "Failed to connect to server");
+
+	ipc::message msg;
+	ipc::message reply;
+	cmd_listener_group_connect_t buf = {0, };
+
+	buf.window = window;
+	buf.count = count;
+	for (int i = 0; i < count; ++i)
+		buf.listener_id[i] = members[i]->get_id();
+
+	msg.set_type(CMD_LISTENER_GROUP_CONNECT);
+	msg.enclose((const char *)&buf, sizeof(buf));
+
+	if (!m_evt_channel->send_sync(msg) || !m_evt_channel->read_sync(reply)) {
+		_E("Failed to connect group");
+		disconnect();
+		return -EIO;
+	}
+
+	if (reply.header()->err < 0) {
+		_E("Failed to connect group[%d]", reply.header()->err);
+		disconnect();
+		return reply.header()->err;
+	}
+
+	reply.disclose((char *)&buf, sizeof(buf));
+
+	m_id = buf.group_id;
+	for (int i = 0; i < count; ++i)
+		m_sensors[buf.sensor_id[i]] = members[i]->get_sensor();
+
+	_I("Connected group[%d] of %d listeners", m_id, count);
+
+	return OP_SUCCESS;
+}
+
+void sensor_group::bind(void)
+{
+	ret_if(!m_evt_channel);
+
+	m_evt_channel->bind();
+}
+
+void sensor_group::disconnect(void)
+{
+	ret_if(!m_evt_channel);
+
+	/* the server hands the members back to their own channels */
+	m_loop->add_channel_release_queue(m_evt_channel);
+	m_evt_channel = NULL;
+
+	_I("Disconnected group[%d]", m_id);
+}
+
+int sensor_group::get_id(void)
+{
+	return m_id;
+}
+
+sensor_t sensor_group::get_sensor(int sensor_id)
+{
+	auto it = m_sensors.find(sensor_id);
+	retv_if(it == m_sensors.end(), NULL);
+
+	return it->second;
+}
@@ -0,0 +1,69 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __SENSOR_GROUP_H__
+#define __SENSOR_GROUP_H__
+
+#include <ipc_client.h>
+#include <channel.h>
+#include <channel_handler.h>
+#include <event_loop.h>
+#include <sensor_types.h>
+#include <map>
+
+#include "sensor_listener.h"
+
+namespace sensor {
+
+/*
+ * A group of connected listeners whose events the server merges into one
+ * stream ordered by timestamp, delivered on the group's own channel.
+ * Each event is tagged with the id of the sensor it came from.
+ */
+class sensor_group {
+public:
+	sensor_group(ipc::event_loop *loop);
+	virtual ~sensor_group();
+
+	/* the group takes the handler over, window is in ms */
+	int connect(sensor_listener **members, int count, int window, ipc::channel_handler *handler);
+
+	/* merged events are read once the group is bound */
+	void bind(void);
+
+	int get_id(void);
+	sensor_t get_sensor(int sensor_id);
+
+private:
+	void disconnect(void);
+
+	int m_id;
+
+	ipc::ipc_client *m_client;
+	ipc::channel *m_evt_channel;
+	ipc::channel_handler *m_handler;
+	ipc::event_loop *m_loop;
+
+	/* {sensor id, sensor} */
+	std::map<int, sensor_t> m_sensors;
+};
+
+}
+
+#endif /* __SENSOR_GROUP_H__ */
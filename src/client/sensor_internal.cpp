@@ -26,6 +26,7 @@
 #include <channel_handler.h>
 #include <sensor_manager.h>
 #include <sensor_listener.h>
+#include <sensor_group.h>
 #include <sensor_provider.h>
 #include <sensor_log.h>
 #include <unordered_map>
@@ -39,6 +40,7 @@
 #define CONVERT_OPTION_TO_PAUSE_POLICY(option) ((option) ^ 0b11)
 #define MAX_LISTENER 100
 #define MAX_PROVIDER 20
+#define MAX_GROUP 20
 
 using namespace sensor;
 
@@ -55,6 +57,7 @@ typedef GSourceFunc callback_dispatcher_t;
 
 static sensor::sensor_manager manager;
 static std::unordered_map<int, sensor::sensor_listener *> listeners;
+static std::unordered_map<int, sensor::sensor_group *> groups;
 static cmutex lock;
 static uint providerCnt = 0;
 
@@ -90,7 +93,15 @@ static gboolean sensor_event_callback_dispatcher(gpointer data)
 		event_type = CONVERT_TYPE_EVENT(info->sensor->get_type());
 
 	if (info->cb && info->sensor && listeners.find(info->listener_id) != listeners.end()) {
-		((sensor_cb_t)info->cb)(info->sensor, event_type, (sensor_data_t*)info->data, info->user_data);
+		size_t element_size = sizeof(sensor_data_t);
+		size_t count = 1;
+
+		/* the server delivers batched samples in one message */
+		if (info->data_size > element_size && info->data_size % element_size == 0)
+			count = info->data_size / element_size;
+
+		for (size_t i = 0; i < count; ++i)
+			((sensor_cb_t)info->cb)(info->sensor, event_type, (sensor_data_t*)info->data + i, info->user_data);
 	}
 
 	delete [] info->data;
@@ -122,7 +133,11 @@ static gboolean sensor_attribute_int_changed_callback_dispatcher(gpointer data)
 
 	if (info->cb && info->sensor && listeners.find(info->listener_id) != listeners.end()) {
 		cmd_listener_attr_int_t *d = (cmd_listener_attr_int_t *)info->data;
-		((sensor_attribute_int_changed_cb_t)info->cb)(info->sensor, d->attribute, d->value, info->user_data);
+		size_t count = info->data_size / sizeof(cmd_listener_attr_int_t);
+
+		/* the changes of one server loop iteration come in one message */
+		for (size_t i = 0; i < count; ++i)
+			((sensor_attribute_int_changed_cb_t)info->cb)(info->sensor, d[i].attribute, d[i].value, info->user_data);
 	}
 
 	delete [] info->data;
@@ -137,8 +152,43 @@ static gboolean sensor_attribute_str_changed_callback_dispatcher(gpointer data)
 	AUTOLOCK(lock);
 
 	if (info->cb && info->sensor && listeners.find(info->listener_id) != listeners.end()) {
-		cmd_listener_attr_str_t *d = (cmd_listener_attr_str_t *)info->data;
-		((sensor_attribute_str_changed_cb_t)info->cb)(info->sensor, d->attribute, d->value, d->len, info->user_data);
+		size_t offset = 0;
+
+		while (offset + sizeof(cmd_listener_attr_str_t) <= info->data_size) {
+			cmd_listener_attr_str_t *d = (cmd_listener_attr_str_t *)(info->data + offset);
+			if (d->len < 0 || offset + sizeof(cmd_listener_attr_str_t) + d->len > info->data_size)
+				break;
+
+			((sensor_attribute_str_changed_cb_t)info->cb)(info->sensor, d->attribute, d->value, d->len, info->user_data);
+			offset += ATTR_STR_RECORD_SIZE(d->len);
+		}
+	}
+
+	delete [] info->data;
+	delete info;
+	return FALSE;
+}
+
+static gboolean sensor_group_callback_dispatcher(gpointer data)
+{
+	callback_info_s *info = (callback_info_s *)data;
+
+	AUTOLOCK(lock);
+
+	auto it = groups.find(info->listener_id);
+	if (info->cb && it != groups.end()) {
+		cmd_listener_group_event_t *events = (cmd_listener_group_event_t *)info->data;
+		size_t count = info->data_size / sizeof(cmd_listener_group_event_t);
+
+		/* the events are already in timestamp order across the sensors */
+		for (size_t i = 0; i < count; ++i) {
+			sensor_info *sensor = static_cast<sensor_info *>(it->second->get_sensor(events[i].sensor_id));
+			if (!sensor)
+				continue;
+
+			((sensor_cb_t)info->cb)(sensor, CONVERT_TYPE_EVENT(sensor->get_type()),
+					&events[i].data, info->user_data);
+		}
 	}
 
 	delete [] info->data;
@@ -192,6 +242,60 @@ private:
 	callback_dispatcher_t m_dispatcher;
 };
 
+class sensor_group_channel_handler : public ipc::channel_handler
+{
+public:
+	sensor_group_channel_handler(void *cb, void *user_data)
+	: m_group_id(0)
+	, m_cb(cb)
+	, m_user_data(user_data)
+	{}
+
+	void set_group_id(int id) { m_group_id = id; }
+
+	void connected(ipc::channel *ch) {}
+	void disconnected(ipc::channel *ch) {}
+	void read(ipc::channel *ch, ipc::message &msg)
+	{
+		callback_info_s *info;
+		auto size = msg.size();
+
+		if (msg.header()->type != CMD_LISTENER_GROUP_EVENT || size == 0)
+			return;
+
+		char *data = new(std::nothrow) char[size];
+		if (data == NULL)
+			return;
+		memcpy(data, msg.body(), size);
+
+		info = new(std::nothrow) callback_info_s();
+		if (info == NULL) {
+			delete [] data;
+			return;
+		}
+
+		info->listener_id = m_group_id;
+		info->cb = m_cb;
+		info->sensor = NULL;
+		info->data = data;
+		info->data_size = size;
+		info->user_data = m_user_data;
+
+		/* one hop per message keeps the merged order */
+		g_idle_add(sensor_group_callback_dispatcher, info);
+	}
+
+	void read_complete(ipc::channel *ch) {}
+	void error_caught(ipc::channel *ch, int error) {}
+	void set_handler(int num, ipc::channel_handler* handler) {}
+	void disconnect(void) {}
+
+private:
+	int m_group_id;
+	void *m_cb;
+	void *m_user_data;
+};
+
 /*
  * TO-DO-LIST:
  * 1. power save option / lcd vconf : move to server
@@ -328,6 +432,12 @@ API bool sensord_is_wakeup_supported(sensor_t sensor)
 	return static_cast<sensor_info *>(sensor)->is_wakeup_supported();
 }
 
+static sensor_reader *get_reader(void)
+{
+	static sensor_reader reader;
+	return &reader;
+}
+
 API int sensord_connect(sensor_t sensor)
 {
 	AUTOLOCK(lock);
@@ -338,9 +448,8 @@ API int sensord_connect(sensor_t sensor)
 	retvm_if(listeners.size() > MAX_LISTENER, -EPERM, "Exceeded the maximum listener");
 
 	sensor::sensor_listener *listener;
-	static sensor_reader reader;
 
-	listener = new(std::nothrow) sensor::sensor_listener(sensor, reader.get_event_loop());
+	listener = new(std::nothrow) sensor::sensor_listener(sensor, get_reader()->get_event_loop());
 	retvm_if(!listener, -ENOMEM, "Failed to allocate memory");
 
 	listeners[listener->get_id()] = listener;
@@ -373,6 +482,68 @@ API bool sensord_disconnect(int handle)
 	return true;
 }
 
+API int sensord_connect_group(const int *handles, int count, unsigned int reorder_window,
+		sensor_cb_t cb, void *user_data)
+{
+	sensor::sensor_listener *members[MAX_GROUP_MEMBERS];
+
+	retvm_if(!handles || !cb, -EINVAL, "Invalid parameter");
+	retvm_if(count <= 0 || count > MAX_GROUP_MEMBERS, -EINVAL, "Invalid count[%d]", count);
+	retvm_if(reorder_window == 0, -EINVAL, "Invalid reorder window");
+
+	AUTOLOCK(lock);
+
+	retvm_if(groups.size() >= MAX_GROUP, -EPERM, "Exceeded the maximum group");
+
+	for (int i = 0; i < count; ++i) {
+		auto it = listeners.find(handles[i]);
+		retvm_if(it == listeners.end(), -EINVAL, "Invalid handle[%d]", handles[i]);
+
+		members[i] = it->second;
+	}
+
+	sensor_group_channel_handler *handler;
+	handler = new(std::nothrow) sensor_group_channel_handler((void *)cb, user_data);
+	retvm_if(!handler, -ENOMEM, "Failed to allocate memory");
+
+	sensor::sensor_group *group;
+	group = new(std::nothrow) sensor::sensor_group(get_reader()->get_event_loop());
+	if (!group) {
+		_E("Failed to allocate memory");
+		delete handler;
+		return -ENOMEM;
+	}
+
+	int ret = group->connect(members, count, reorder_window, handler);
+	if (ret < 0) {
+		delete group;
+		return ret;
+	}
+
+	handler->set_group_id(group->get_id());
+	groups[group->get_id()] = group;
+	group->bind();
+
+	_D("Connect group[%d]", group->get_id());
+
+	return group->get_id();
+}
+
+API int sensord_disconnect_group(int group_handle)
+{
+	AUTOLOCK(lock);
+
+	auto it = groups.find(group_handle);
+	retvm_if(it == groups.end(), -EINVAL, "Invalid group[%d]", group_handle);
+
+	_D("Disconnect group[%d]", group_handle);
+
+	delete it->second;
+	groups.erase(it);
+
+	return OP_SUCCESS;
+}
+
 static inline bool sensord_register_event_impl(int handle, unsigned int event_type,
 		unsigned int interval, unsigned int max_batch_latency, void* cb, bool is_events_callback, void *user_data)
 {
@@ -811,6 +982,48 @@ API int sensord_get_attribute_int(sensor_t sensor, int attribute, int* value)
 	return OP_SUCCESS;
 }
 
+API int sensord_get_stats(int type, char **stats, int *len)
+{
+	if (!stats || !len) {
+		_E("Failed to validate the parameter");
+		return -EINVAL;
+	}
+
+	/* lock statistics of this process don't need the server */
+	if (type == SENSORD_STATS_CLIENT_LOCK) {
+		std::string str;
+		lock_profiler::get_stats(str);
+
+		*stats = strdup(str.c_str());
+		retvm_if(!*stats, -ENOMEM, "Failed to allocate memory");
+		*len = str.size() + 1;
+
+		return OP_SUCCESS;
+	}
+
+	retvm_if(!manager.connect(), -EIO, "Failed to connect");
+
+	int ret = manager.get_stats(type, stats, len);
+	if (ret < 0) {
+		_E("Failed to get stats[%d]", type);
+		return ret;
+	}
+
+	return OP_SUCCESS;
+}
+
+API int sensord_set_reader_thread_policy(const char *policy)
+{
+	if (!policy) {
+		_E("Failed to validate the parameter");
+		return -EINVAL;
+	}
+
+	AUTOLOCK(lock);
+
+	return get_reader()->set_thread_policy(policy);
+}
+
 API bool sensord_get_data(int handle, unsigned int data_id, sensor_data_t* sensor_data)
 {
 	sensor::sensor_listener *listener;
@@ -849,6 +1062,47 @@ API bool sensord_get_data_list(int handle, unsigned int data_id, sensor_data_t**
 	return true;
 }
 
+API int sensord_get_data_history(int handle, unsigned long long start_time, unsigned long long end_time,
+		sensor_data_t **sensor_data, int *count)
+{
+	sensor::sensor_listener *listener;
+
+	retvm_if(!sensor_data || !count, -EINVAL, "Invalid parameter");
+	retvm_if(!start_time && !end_time, -EINVAL, "Invalid time range");
+
+	AUTOLOCK(lock);
+
+	auto it = listeners.find(handle);
+	retvm_if(it == listeners.end(), -EINVAL, "Invalid handle[%d]", handle);
+
+	listener = it->second;
+
+	return listener->get_sensor_data_list(sensor_data, count, start_time, end_time);
+}
+
+API int sensord_get_data_snapshot(const int *handles, int count, sensor_data_t *sensor_data)
+{
+	int ids[MAX_SNAPSHOT_COUNT];
+
+	retvm_if(!handles || !sensor_data, -EINVAL, "Invalid parameter");
+	retvm_if(count <= 0 || count > MAX_SNAPSHOT_COUNT, -EINVAL, "Invalid count[%d]", count);
+
+	{
+		AUTOLOCK(lock);
+
+		for (int i = 0; i < count; ++i) {
+			auto it = listeners.find(handles[i]);
+			retvm_if(it == listeners.end(), -EINVAL, "Invalid handle[%d]", handles[i]);
+
+			ids[i] = it->second->get_id();
+		}
+	}
+
+	retvm_if(!manager.connect(), -EIO, "Failed to connect");
+
+	return manager.get_snapshot(ids, count, sensor_data);
+}
+
 API bool sensord_flush(int handle)
 {
 	sensor::sensor_listener *listener;
@@ -205,6 +205,10 @@ void sensor_listener::restore(void)
 	_D("Restoring sensor listener");
 
 	/* Restore attributes/status */
+	auto passive = m_attributes_int.find(SENSORD_ATTRIBUTE_PASSIVE_MODE);
+	if (passive != m_attributes_int.end())
+		set_passive_mode(m_attributes_int[SENSORD_ATTRIBUTE_PASSIVE_MODE]);
+
 	if (m_started.load())
 		start();
 
@@ -220,6 +224,54 @@ void sensor_listener::restore(void)
 	if (power != m_attributes_int.end())
 		set_attribute(SENSORD_ATTRIBUTE_PAUSE_POLICY, m_attributes_int[SENSORD_ATTRIBUTE_PAUSE_POLICY]);
 
+	auto decimation = m_attributes_int.find(SENSORD_ATTRIBUTE_DECIMATION);
+	if (decimation != m_attributes_int.end())
+		set_attribute(SENSORD_ATTRIBUTE_DECIMATION, m_attributes_int[SENSORD_ATTRIBUTE_DECIMATION]);
+
+	auto queue_policy = m_attributes_int.find(SENSORD_ATTRIBUTE_QUEUE_POLICY);
+	if (queue_policy != m_attributes_int.end())
+		set_attribute(SENSORD_ATTRIBUTE_QUEUE_POLICY, m_attributes_int[SENSORD_ATTRIBUTE_QUEUE_POLICY]);
+
+	auto queue_size = m_attributes_int.find(SENSORD_ATTRIBUTE_QUEUE_SIZE);
+	if (queue_size != m_attributes_int.end())
+		set_attribute(SENSORD_ATTRIBUTE_QUEUE_SIZE, m_attributes_int[SENSORD_ATTRIBUTE_QUEUE_SIZE]);
+
+	auto deadline = m_attributes_int.find(SENSORD_ATTRIBUTE_DELIVERY_DEADLINE);
+	if (deadline != m_attributes_int.end())
+		set_attribute(SENSORD_ATTRIBUTE_DELIVERY_DEADLINE, m_attributes_int[SENSORD_ATTRIBUTE_DELIVERY_DEADLINE]);
+
+	auto filter = m_attributes_int.find(SENSORD_ATTRIBUTE_FILTER);
+	if (filter != m_attributes_int.end())
+		set_attribute(SENSORD_ATTRIBUTE_FILTER, m_attributes_int[SENSORD_ATTRIBUTE_FILTER]);
+
+	auto cutoff = m_attributes_int.find(SENSORD_ATTRIBUTE_FILTER_CUTOFF);
+	if (cutoff != m_attributes_int.end())
+		set_attribute(SENSORD_ATTRIBUTE_FILTER_CUTOFF, m_attributes_int[SENSORD_ATTRIBUTE_FILTER_CUTOFF]);
+
+	auto aggregation = m_attributes_int.find(SENSORD_ATTRIBUTE_AGGREGATION);
+	if (aggregation != m_attributes_int.end())
+		set_attribute(SENSORD_ATTRIBUTE_AGGREGATION, m_attributes_int[SENSORD_ATTRIBUTE_AGGREGATION]);
+
+	auto window = m_attributes_int.find(SENSORD_ATTRIBUTE_AGGREGATION_WINDOW);
+	if (window != m_attributes_int.end())
+		set_attribute(SENSORD_ATTRIBUTE_AGGREGATION_WINDOW, m_attributes_int[SENSORD_ATTRIBUTE_AGGREGATION_WINDOW]);
+
+	auto report_mode = m_attributes_int.find(SENSORD_ATTRIBUTE_REPORT_MODE);
+	if (report_mode != m_attributes_int.end())
+		set_attribute(SENSORD_ATTRIBUTE_REPORT_MODE, m_attributes_int[SENSORD_ATTRIBUTE_REPORT_MODE]);
+
+	auto abs_threshold = m_attributes_int.find(SENSORD_ATTRIBUTE_ABS_THRESHOLD);
+	if (abs_threshold != m_attributes_int.end())
+		set_attribute(SENSORD_ATTRIBUTE_ABS_THRESHOLD, m_attributes_int[SENSORD_ATTRIBUTE_ABS_THRESHOLD]);
+
+	auto rel_threshold = m_attributes_int.find(SENSORD_ATTRIBUTE_REL_THRESHOLD);
+	if (rel_threshold != m_attributes_int.end())
+		set_attribute(SENSORD_ATTRIBUTE_REL_THRESHOLD, m_attributes_int[SENSORD_ATTRIBUTE_REL_THRESHOLD]);
+
+	auto changes = m_attributes_int.find(SENSORD_ATTRIBUTE_CHANGE_SUBSCRIPTION);
+	if (changes != m_attributes_int.end())
+		set_attribute(SENSORD_ATTRIBUTE_CHANGE_SUBSCRIPTION, m_attributes_int[SENSORD_ATTRIBUTE_CHANGE_SUBSCRIPTION]);
+
 	_D("Restored listener[%d]", get_id());
 	lock.unlock();
 }
@@ -331,6 +383,7 @@ void sensor_listener::set_attribute_int_changed_handler(ipc::channel_handler *ha
 	if (m_attr_int_changed_handler)
 		m_loop->add_channel_handler_release_list(m_attr_int_changed_handler);
 	m_attr_int_changed_handler = handler;
+	update_attribute_changes();
 }
 
 void sensor_listener::unset_attribute_int_changed_handler(void)
@@ -339,6 +392,7 @@ void sensor_listener::unset_attribute_int_changed_handler(void)
 		m_handler->set_handler(2, NULL);
 		m_loop->add_channel_handler_release_list(m_attr_int_changed_handler);
 		m_attr_int_changed_handler = NULL;
+		update_attribute_changes();
 	}
 }
 
@@ -353,6 +407,7 @@ void sensor_listener::set_attribute_str_changed_handler(ipc::channel_handler *ha
 	if (m_attr_str_changed_handler)
 		m_loop->add_channel_handler_release_list(m_attr_str_changed_handler);
 	m_attr_str_changed_handler = handler;
+	update_attribute_changes();
 }
 
 void sensor_listener::unset_attribute_str_changed_handler(void)
@@ -361,9 +416,26 @@ void sensor_listener::unset_attribute_str_changed_handler(void)
 		m_handler->set_handler(3, NULL);
 		m_loop->add_channel_handler_release_list(m_attr_str_changed_handler);
 		m_attr_str_changed_handler = NULL;
+		update_attribute_changes();
 	}
 }
 
+/* the server only notifies the attribute changes this listener has a handler for */
+void sensor_listener::update_attribute_changes(void)
+{
+	int changes = SENSORD_ATTRIBUTE_CHANGE_NONE;
+
+	if (m_attr_int_changed_handler)
+		changes |= SENSORD_ATTRIBUTE_CHANGE_INT;
+	if (m_attr_str_changed_handler)
+		changes |= SENSORD_ATTRIBUTE_CHANGE_STR;
+
+	ret_if(!is_connected());
+
+	if (set_attribute(SENSORD_ATTRIBUTE_CHANGE_SUBSCRIPTION, changes) < 0)
+		_E("Failed to subscribe attribute changes[%d]", changes);
+}
+
 int sensor_listener::start(void)
 {
 	ipc::message msg;
@@ -675,7 +747,8 @@ int sensor_listener::get_sensor_data(sensor_data_t *data)
 	return OP_SUCCESS;
 }
 
-int sensor_listener::get_sensor_data_list(sensor_data_t **data, int *count)
+int sensor_listener::get_sensor_data_list(sensor_data_t **data, int *count,
+		unsigned long long start_time, unsigned long long end_time)
 {
 	ipc::message msg;
 	ipc::message reply;
@@ -684,6 +757,8 @@ int sensor_listener::get_sensor_data_list(sensor_data_t **data, int *count)
 	retvm_if(!m_cmd_channel, -EIO, "Failed to connect to server");
 
 	buf.listener_id = m_id;
+	buf.start_time = start_time;
+	buf.end_time = end_time;
 	msg.set_type(CMD_LISTENER_GET_DATA_LIST);
 	msg.enclose((char *)&buf, sizeof(buf));
 
@@ -76,7 +76,8 @@ public:
 	int get_attribute(int attribute, char **value, int *len);
 	void update_attribute(int attribute, const char *value, int len);
 	int get_sensor_data(sensor_data_t *data);
-	int get_sensor_data_list(sensor_data_t **data, int *count);
+	int get_sensor_data_list(sensor_data_t **data, int *count,
+			unsigned long long start_time = 0, unsigned long long end_time = 0);
 	int flush(void);
 
 	void restore(void);
@@ -88,6 +89,7 @@ private:
 	bool connect(void);
 	void disconnect(void);
 	bool is_connected(void);
+	void update_attribute_changes(void);
 
 	int m_id;
 	sensor_info *m_sensor;
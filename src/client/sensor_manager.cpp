@@ -210,6 +210,123 @@ int sensor_manager::get_attribute(sensor_t sensor, int attribute, int *value)
 	return OP_SUCCESS;
 }
 
+int sensor_manager::get_stats(int type, char **stats, int *len)
+{
+	if (!stats || !len) {
+		_E("Failed to validate the parameters");
+		return -EINVAL;
+	}
+
+	if (!m_cmd_channel) {
+		_E("Failed to connect to server");
+		return -EIO;
+	}
+
+	ipc::message msg;
+	ipc::message reply;
+	cmd_manager_stats_t buf = {0, };
+
+	buf.type = type;
+
+	msg.set_type(CMD_MANAGER_GET_STATS);
+	msg.enclose((char *)&buf, sizeof(buf));
+
+	bool ret = m_cmd_channel->send_sync(msg);
+	if (!ret) {
+		_E("Failed to send command to get stats");
+		return -EIO;
+	}
+
+	ret = m_cmd_channel->read_sync(reply);
+	if (!ret) {
+		_E("Failed to read reply to get stats");
+		return -EIO;
+	}
+
+	if (reply.header()->err < 0) {
+		_E("Failed to get stats");
+		return reply.header()->err;
+	}
+
+	if (reply.header()->length <= sizeof(cmd_manager_stats_t) || !reply.body()) {
+		_E("Failed to get stats");
+		return -EIO;
+	}
+
+	cmd_manager_stats_t *reply_buf = (cmd_manager_stats_t *)reply.body();
+
+	*stats = (char *) malloc(reply_buf->len);
+	retvm_if(!*stats, -ENOMEM, "Failed to allocate memory");
+
+	memcpy(*stats, reply_buf->stats, reply_buf->len);
+	*len = reply_buf->len;
+
+	return OP_SUCCESS;
+}
+
+int sensor_manager::get_snapshot(const int *listener_ids, int count, sensor_data_t *data)
+{
+	if (!listener_ids || !data || count <= 0 || count > MAX_SNAPSHOT_COUNT) {
+		_E("Failed to validate the parameters");
+		return -EINVAL;
+	}
+
+	if (!m_cmd_channel) {
+		_E("Failed to connect to server");
+		return -EIO;
+	}
+
+	size_t size = sizeof(cmd_manager_snapshot_t) +
+			sizeof(cmd_manager_snapshot_entry_t) * count;
+	cmd_manager_snapshot_t *buf = (cmd_manager_snapshot_t *) new(std::nothrow) char[size];
+	retvm_if(!buf, -ENOMEM, "Failed to allocate memory");
+
+	memset(buf, 0, size);
+	buf->count = count;
+	for (int i = 0; i < count; ++i)
+		buf->entries[i].listener_id = listener_ids[i];
+
+	ipc::message msg;
+	ipc::message reply;
+
+	msg.set_type(CMD_MANAGER_SNAPSHOT);
+	msg.enclose((char *)buf, size);
+	delete [] buf;
+
+	bool ret = m_cmd_channel->send_sync(msg);
+	if (!ret) {
+		_E("Failed to send command to get snapshot");
+		return -EIO;
+	}
+
+	ret = m_cmd_channel->read_sync(reply);
+	if (!ret) {
+		_E("Failed to read reply to get snapshot");
+		return -EIO;
+	}
+
+	if (reply.header()->err < 0) {
+		_E("Failed to get snapshot");
+		return reply.header()->err;
+	}
+
+	if (reply.header()->length < size || !reply.body()) {
+		_E("Failed to get snapshot");
+		return -EIO;
+	}
+
+	cmd_manager_snapshot_t *reply_buf = (cmd_manager_snapshot_t *)reply.body();
+	int valid = 0;
+
+	for (int i = 0; i < count; ++i) {
+		memcpy(&data[i], &reply_buf->entries[i].data, sizeof(sensor_data_t));
+		if (reply_buf->entries[i].err == OP_SUCCESS)
+			++valid;
+	}
+
+	return valid;
+}
+
 int sensor_manager::add_sensor(sensor_info &info)
 {
 	retv_if(is_supported(info.get_uri().c_str()), OP_ERROR);
@@ -50,6 +50,9 @@ public:
 	int set_attribute(sensor_t sensor, int attribute, int value);
 	int get_attribute(sensor_t sensor, int attribute, int *value);
 
+	int get_stats(int type, char **stats, int *len);
+	int get_snapshot(const int *listener_ids, int count, sensor_data_t *data);
+
 	/* sensor provider */
 	int add_sensor(sensor_info &info);
 	int add_sensor(sensor_provider *provider);
@@ -21,8 +21,12 @@
 
 #include <sensor_log.h>
 #include <sensor_types.h>
+#include <stdlib.h>
 #include <chrono>
 
+#define READER_THREAD_NAME "sensor-reader"
+#define READER_THREAD_POLICY_ENV "SENSOR_READER_THREAD_POLICY"
+
 using namespace sensor;
 
 sensor_reader::sensor_reader()
@@ -68,6 +72,35 @@ ipc::event_loop *sensor_reader::get_event_loop(void)
 	return m_event_loop;
 }
 
+int sensor_reader::set_thread_policy(const char *policy)
+{
+	retvm_if(!m_event_loop, -EIO, "Invalid context");
+
+	thread_policy *tp = new(std::nothrow) thread_policy();
+	retvm_if(!tp, -ENOMEM, "Failed to allocate memory");
+
+	if (!tp->parse(policy)) {
+		delete tp;
+		return -EINVAL;
+	}
+
+	/* the policy has to be applied by the reader thread itself */
+	if (m_event_loop->add_idle_event(ipc::EVENT_PRIORITY_DEFAULT, apply_thread_policy, tp) == 0) {
+		delete tp;
+		return -EIO;
+	}
+
+	return OP_SUCCESS;
+}
+
+void sensor_reader::apply_thread_policy(size_t id, void *data)
+{
+	thread_policy *tp = (thread_policy *)data;
+
+	tp->apply(READER_THREAD_NAME);
+	delete tp;
+}
+
 void sensor_reader::wait_for_preparation(void)
 {
 	std::unique_lock<std::mutex> lock(m_mutex);
@@ -76,7 +109,15 @@ void sensor_reader::wait_for_preparation(void)
 
 void sensor_reader::read_event(void)
 {
+	thread_policy policy;
+
 	_I("RUN");
+
+	if (!policy.parse(getenv(READER_THREAD_POLICY_ENV)))
+		policy = thread_policy();
+
+	policy.apply(READER_THREAD_NAME);
+
 	m_loop = g_main_loop_new(g_main_context_new(), false);
 	m_event_loop->set_mainloop(m_loop);
 
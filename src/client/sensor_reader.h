@@ -22,6 +22,7 @@
 
 #include <glib.h>
 #include <event_loop.h>
+#include <thread_policy.h>
 
 #include <thread>
 #include <atomic>
@@ -36,9 +37,12 @@ public:
 
 	ipc::event_loop *get_event_loop(void);
 
+	int set_thread_policy(const char *policy);
+
 private:
 	void wait_for_preparation(void);
 	void read_event(void);
+	static void apply_thread_policy(size_t id, void *data);
 
 	std::thread *m_reader;
 	GMainLoop *m_loop;
@@ -0,0 +1,141 @@
+/*
+ * sensorctl
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "recorder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <map>
+#include <sensor_internal.h>
+
+#include "log.h"
+
+#define RECORDER_ARGC 3 /* e.g. {sensorctl, recorder, dump} */
+
+using namespace sensor;
+
+bool recorder_manager::run(int argc, char *argv[])
+{
+	if (argc < RECORDER_ARGC) {
+		usage();
+		return false;
+	}
+
+	if (!strcmp(argv[2], "dump"))
+		return dump();
+
+	if (!strcmp(argv[2], "decode")) {
+		if (argc > RECORDER_ARGC)
+			return decode(argv[3]);
+		return decode(FLIGHT_RECORDER_PATH);
+	}
+
+	usage();
+	return false;
+}
+
+bool recorder_manager::dump(void)
+{
+	char *stats = NULL;
+	int len = 0;
+
+	int ret = sensord_get_stats(SENSORD_STATS_FLIGHT_RECORDER, &stats, &len);
+	RETVM_IF(ret < 0, false, "Failed to dump flight recorder : %d\n", ret);
+
+	_N("%s", stats);
+
+	free(stats);
+	return true;
+}
+
+bool recorder_manager::decode(const char *path)
+{
+	std::vector<flight_record_t> records;
+
+	RETVM_IF(!flight_recorder::load(path, records), false, "Failed to load %s\n", path);
+
+	print(records);
+	return true;
+}
+
+void recorder_manager::print(const std::vector<flight_record_t> &records)
+{
+	/* {channel fd, listener}, from the connections still in the ring */
+	std::map<int64_t, int32_t> listeners;
+
+	if (records.empty()) {
+		_N("No records\n");
+		return;
+	}
+
+	uint64_t base = records.front().time;
+
+	_N("%12s  %-8s  %s\n", "time(ms)", "event", "details");
+
+	for (auto &r : records) {
+		double time = (double)(r.time - base) / 1000;
+
+		switch (r.type) {
+		case FLIGHT_RECORD_SAMPLE:
+			_N("%12.3f  %-8s  sensor[%d] %" PRId64 " samples, newest %" PRId64 "\n",
+					time, "sample", r.id, r.b, r.a);
+			break;
+		case FLIGHT_RECORD_DELIVERY:
+			_N("%12.3f  %-8s  listener[%d] %" PRId64 " samples, newest %" PRId64 "\n",
+					time, "deliver", r.id, r.b, r.a);
+			break;
+		case FLIGHT_RECORD_DROP: {
+			auto it = listeners.find(r.id);
+			if (it != listeners.end())
+				_N("%12.3f  %-8s  listener[%d] fd[%d] message 0x%" PRIx64 ", %" PRId64 " dropped so far\n",
+						time, "drop", it->second, r.id, r.b, r.a);
+			else
+				_N("%12.3f  %-8s  fd[%d] message 0x%" PRIx64 ", %" PRId64 " dropped so far\n",
+						time, "drop", r.id, r.b, r.a);
+			break;
+		}
+		case FLIGHT_RECORD_COMMAND:
+			_N("%12.3f  %-8s  0x%x took %" PRId64 " us, result %" PRId64 "\n",
+					time, "command", r.id, r.a, r.b);
+			break;
+		case FLIGHT_RECORD_CONNECT:
+			listeners[r.a] = r.id;
+			_N("%12.3f  %-8s  listener[%d] fd[%" PRId64 "] sensor[%" PRId64 "]\n",
+					time, "connect", r.id, r.a, r.b);
+			break;
+		default:
+			_N("%12.3f  %-8s  type[%u] id[%d]\n", time, "unknown", r.type, r.id);
+			break;
+		}
+	}
+
+	_N("%zu records over %.3f ms\n", records.size(), (double)(records.back().time - base) / 1000);
+}
+
+void recorder_manager::usage(void)
+{
+	_N("usage: sensorctl recorder <command> [<file>]\n\n");
+
+	_N("The recorder commands are:\n");
+	_N("  dump:   write the flight recorder of sensord to its file\n");
+	_N("  decode: print the timeline of a dump, %s by default\n", FLIGHT_RECORDER_PATH);
+	_N("sensord also writes the dump when it receives SIGUSR2.\n");
+}
@@ -0,0 +1,37 @@
+/*
+ * sensorctl
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once /* __RECORDER_MANAGER_H__ */
+
+#include <vector>
+#include <flight_recorder.h>
+#include "sensor_manager.h"
+
+class recorder_manager : public sensor_manager {
+public:
+	recorder_manager() {}
+	virtual ~recorder_manager() {}
+
+	bool run(int argc, char *argv[]);
+private:
+	bool dump(void);
+	bool decode(const char *path);
+	void print(const std::vector<sensor::flight_record_t> &records);
+	void usage(void);
+};
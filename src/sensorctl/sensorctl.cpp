@@ -28,6 +28,8 @@
 #include "injector.h"
 #include "info.h"
 #include "loopback.h"
+#include "stats.h"
+#include "recorder.h"
 #include "sensor_adapter.h"
 
 static sensor_manager *manager;
@@ -40,6 +42,8 @@ static void usage(void)
 	_N("  test:   test sensor(s)\n");
 	_N("  inject: inject the event to sensor\n");
 	_N("  info:   show sensor infos\n");
+	_N("  stats:  show sensord statistics\n");
+	_N("  recorder: dump and decode the sensord flight recorder\n");
 }
 
 static sensor_manager *create_manager(char *command)
@@ -57,6 +61,10 @@ static sensor_manager *create_manager(char *command)
 		manager = new(std::nothrow) info_manager;
 	} else if (!strcmp(command, "loopback")) {
 		manager = new(std::nothrow) loopback_manager;
+	} else if (!strcmp(command, "stats")) {
+		manager = new(std::nothrow) stats_manager;
+	} else if (!strcmp(command, "recorder")) {
+		manager = new(std::nothrow) recorder_manager;
 	}
 
 	if (!manager) {
@@ -0,0 +1,80 @@
+/*
+ * sensorctl
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "stats.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sensor_internal.h>
+
+#include "log.h"
+
+#define STATS_ARGC 3 /* e.g. {sensorctl, stats, loop} */
+
+bool stats_manager::run(int argc, char *argv[])
+{
+	int type;
+	char *stats = NULL;
+	int len = 0;
+
+	if (argc < STATS_ARGC) {
+		usage();
+		return false;
+	}
+
+	type = get_stats_type(argv[2]);
+	RETVM_IF(type < 0, false, "Wrong argument : %s\n", argv[2]);
+
+	int ret = sensord_get_stats(type, &stats, &len);
+	RETVM_IF(ret < 0, false, "Failed to get stats : %d\n", ret);
+
+	_N("%s", stats);
+
+	free(stats);
+	return true;
+}
+
+int stats_manager::get_stats_type(const char *name)
+{
+	if (!strcmp(name, "loop"))
+		return SENSORD_STATS_EVENT_LOOP;
+	else if (!strcmp(name, "lock"))
+		return SENSORD_STATS_LOCK;
+	else if (!strcmp(name, "client_lock"))
+		return SENSORD_STATS_CLIENT_LOCK;
+	else if (!strcmp(name, "copy"))
+		return SENSORD_STATS_EVENT_COPY;
+	else if (!strcmp(name, "budget"))
+		return SENSORD_STATS_CLIENT_BUDGET;
+
+	return -1;
+}
+
+void stats_manager::usage(void)
+{
+	_N("usage: sensorctl stats <type>\n\n");
+
+	_N("The stats types are:\n");
+	_N("  loop:        event loop dispatch time per handler\n");
+	_N("  lock:        lock contention per call site of sensord\n");
+	_N("  client_lock: lock contention per call site of this process\n");
+	_N("  copy:        sensor samples delivered and copied by sensord\n");
+	_N("  budget:      event budget of each client\n");
+}
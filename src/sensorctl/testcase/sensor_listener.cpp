@@ -17,8 +17,19 @@
  *
  */
 
+#include <stdio.h>
 #include <unistd.h>
 #include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <atomic>
+#include <new>
+#include <map>
+#include <string>
+#include <vector>
 #include <sensor_internal.h>
 #include <sensor_utils.h>
 
@@ -802,3 +813,1141 @@ TESTCASE(skip_sensor_listener, light_sensor_get_attribute_int_1)
 
 	return true;
 }
+
+#define FLOOD_DURATION_US 10000000
+#define FLOOD_MIN_REQUESTS 1000
+
+/* Keeps the server busy with CMD_LISTENER_GET_DATA as fast as it can,
+ * until it is killed or FLOOD_DURATION_US passes */
+static int flood_get_data(std::atomic<uint64_t> *requests)
+{
+	int handle;
+	sensor_t sensor;
+	sensor_data_t data;
+	unsigned long long start;
+
+	if (sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor) < 0)
+		return EXIT_FAILURE;
+
+	handle = sensord_connect(sensor);
+	if (handle < 0)
+		return EXIT_FAILURE;
+
+	if (!sensord_start(handle, SENSOR_OPTION_ALWAYS_ON)) {
+		sensord_disconnect(handle);
+		return EXIT_FAILURE;
+	}
+
+	/* every call is a round trip to the server, whether data is ready or not */
+	start = sensor::utils::get_timestamp();
+	while (sensor::utils::get_timestamp() - start < FLOOD_DURATION_US) {
+		sensord_get_data(handle, 0, &data);
+		requests->fetch_add(1);
+	}
+
+	sensord_stop(handle);
+	sensord_disconnect(handle);
+
+	return EXIT_SUCCESS;
+}
+
+TESTCASE(sensor_listener, get_data_flood_stress_p_1)
+{
+	int err;
+	bool ret;
+	int handle;
+	int status = 0;
+	pid_t pid;
+	sensor_t sensor;
+	bool flooding;
+	uint64_t flooded;
+	unsigned long long start;
+	unsigned long long elapsed = 0;
+	std::atomic<uint64_t> *requests;
+
+	count = 0;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	/* the flooding child counts its requests where the parent can read them */
+	void *shared = mmap(NULL, sizeof(*requests), PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	ASSERT_NE(shared, MAP_FAILED);
+	requests = new(shared) std::atomic<uint64_t>(0);
+
+	pid = fork();
+	if (pid == 0)
+		_exit(flood_get_data(requests));
+
+	if (pid < 0) {
+		munmap(shared, sizeof(*requests));
+		ASSERT_GE(pid, 0);
+	}
+
+	/* let the flooding client saturate the command channel */
+	usleep(500000);
+	flooded = requests->load();
+
+	handle = sensord_connect(sensor);
+	ret = sensord_register_event(handle, 1, 100, 0, event_cb, NULL);
+
+	if (ret) {
+		start = sensor::utils::get_timestamp();
+		ret = sensord_start(handle, 0);
+		if (ret) {
+			mainloop::run();
+			elapsed = sensor::utils::get_timestamp() - start;
+			sensord_stop(handle);
+		}
+		sensord_unregister_event(handle, 1);
+	}
+
+	flooded = requests->load() - flooded;
+
+	/* the child is killed only if it is still flooding, otherwise it is reaped as it exited */
+	flooding = (waitpid(pid, &status, WNOHANG) == 0);
+	if (flooding) {
+		kill(pid, SIGTERM);
+		waitpid(pid, &status, 0);
+	}
+	munmap(shared, sizeof(*requests));
+
+	ASSERT_TRUE(ret);
+
+	/* [TEST] the flooding client kept running and loaded the server meanwhile */
+	ASSERT_TRUE(flooding);
+	ASSERT_TRUE(WIFSIGNALED(status));
+	ASSERT_EQ(WTERMSIG(status), SIGTERM);
+	ASSERT_GE(flooded, (uint64_t)FLOOD_MIN_REQUESTS);
+
+	/* [TEST] 5 events at 100ms must not be delayed by the flooding client */
+	ASSERT_LT(elapsed, 2000000ULL);
+
+	ret = sensord_disconnect(handle);
+	ASSERT_TRUE(ret);
+
+	return true;
+}
+
+#define DECIMATION_FAST_INTERVAL 10
+#define DECIMATION_SLOW_INTERVAL 200
+#define DECIMATION_DURATION_MS 2000
+
+static int slow_count = 0;
+
+static void decimated_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+	slow_count++;
+}
+
+static void fast_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+}
+
+static gboolean stop_mainloop(gpointer gdata)
+{
+	mainloop::stop();
+	return FALSE;
+}
+
+TESTCASE(sensor_listener, decimation_p_1)
+{
+	int err;
+	bool ret;
+	int fast, slow;
+	sensor_t sensor;
+
+	slow_count = 0;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	fast = sensord_connect(sensor);
+	slow = sensord_connect(sensor);
+
+	ret = sensord_register_event(fast, 1, DECIMATION_FAST_INTERVAL, 0, fast_cb, NULL);
+	ASSERT_TRUE(ret);
+	ret = sensord_register_event(slow, 1, DECIMATION_SLOW_INTERVAL, 0, decimated_cb, NULL);
+	ASSERT_TRUE(ret);
+
+	ret = sensord_start(fast, 0);
+	ASSERT_TRUE(ret);
+	ret = sensord_start(slow, 0);
+	ASSERT_TRUE(ret);
+
+	g_timeout_add(DECIMATION_DURATION_MS, stop_mainloop, NULL);
+	mainloop::run();
+
+	/* [TEST] the slow listener only gets its own rate, not the fast one */
+	ASSERT_GT(slow_count, 0);
+	ASSERT_LE(slow_count, DECIMATION_DURATION_MS / DECIMATION_SLOW_INTERVAL + 2);
+
+	sensord_stop(slow);
+	sensord_stop(fast);
+	sensord_unregister_event(slow, 1);
+	sensord_unregister_event(fast, 1);
+	sensord_disconnect(slow);
+	sensord_disconnect(fast);
+
+	return true;
+}
+
+#define BATCH_INTERVAL 10
+#define BATCH_LATENCY 500
+#define BATCH_DURATION_MS 2000
+
+static int batch_wakeups = 0;
+static int batch_samples = 0;
+
+static void batch_cb(sensor_t sensor, unsigned int event_type, sensor_data_t events[], int events_count, void *user_data)
+{
+	batch_wakeups++;
+	batch_samples += events_count;
+}
+
+TESTCASE(sensor_listener, server_batching_p_1)
+{
+	int err;
+	bool ret;
+	int handle;
+	sensor_t sensor;
+
+	batch_wakeups = 0;
+	batch_samples = 0;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	handle = sensord_connect(sensor);
+	ret = sensord_register_events(handle, 1, BATCH_LATENCY, batch_cb, NULL);
+	ASSERT_TRUE(ret);
+
+	ret = sensord_start(handle, 0);
+	ASSERT_TRUE(ret);
+	ret = sensord_change_event_interval(handle, 0, BATCH_INTERVAL);
+	ASSERT_TRUE(ret);
+
+	g_timeout_add(BATCH_DURATION_MS, stop_mainloop, NULL);
+	mainloop::run();
+
+	/* [TEST] samples arrive in batches, not one wakeup per sample */
+	ASSERT_GT(batch_samples, batch_wakeups);
+	ASSERT_LE(batch_wakeups, BATCH_DURATION_MS / BATCH_LATENCY + 2);
+
+	sensord_stop(handle);
+	sensord_unregister_events(handle, 1);
+	sensord_disconnect(handle);
+
+	return true;
+}
+
+static int passive_count = 0;
+
+static void passive_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+	passive_count++;
+}
+
+TESTCASE(sensor_listener, passive_mode_p_1)
+{
+	int err;
+	bool ret;
+	int active, passive;
+	sensor_t sensor;
+
+	passive_count = 0;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	passive = sensord_connect(sensor);
+	ret = sensord_set_passive_mode(passive, true);
+	ASSERT_TRUE(ret);
+	ret = sensord_register_event(passive, 1, 100, 0, passive_cb, NULL);
+	ASSERT_TRUE(ret);
+	ret = sensord_start(passive, 0);
+	ASSERT_TRUE(ret);
+
+	g_timeout_add(1000, stop_mainloop, NULL);
+	mainloop::run();
+
+	/* [TEST] a passive listener alone does not turn the sensor on */
+	ASSERT_EQ(passive_count, 0);
+
+	active = sensord_connect(sensor);
+	ret = sensord_register_event(active, 1, 100, 0, fast_cb, NULL);
+	ASSERT_TRUE(ret);
+	ret = sensord_start(active, 0);
+	ASSERT_TRUE(ret);
+
+	g_timeout_add(1000, stop_mainloop, NULL);
+	mainloop::run();
+
+	/* [TEST] it receives events while an active listener runs the sensor */
+	ASSERT_GT(passive_count, 0);
+
+	sensord_stop(active);
+	sensord_stop(passive);
+	sensord_unregister_event(active, 1);
+	sensord_unregister_event(passive, 1);
+	sensord_disconnect(active);
+	sensord_disconnect(passive);
+
+	return true;
+}
+
+static bool get_copy_stats(unsigned long long *delivered, unsigned long long *copied)
+{
+	char *stats = NULL;
+	int len = 0;
+	unsigned long long acquired, cached;
+
+	ASSERT_EQ(sensord_get_stats(SENSORD_STATS_EVENT_COPY, &stats, &len), 0);
+
+	/* skip the header line */
+	char *line = strchr(stats, '\n');
+	bool has_values = (line != NULL);
+	ASSERT_TRUE(has_values);
+	ASSERT_EQ(sscanf(line + 1, "%llu %llu %llu %llu", &acquired, &cached, delivered, copied), 4);
+
+	free(stats);
+	return true;
+}
+
+TESTCASE(sensor_listener, copies_per_delivery_p_1)
+{
+	int err;
+	bool ret;
+	int handle;
+	sensor_t sensor;
+	unsigned long long delivered[2], copied[2];
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	ASSERT_TRUE(get_copy_stats(&delivered[0], &copied[0]));
+
+	handle = sensord_connect(sensor);
+	ret = sensord_register_event(handle, 1, 10, 0, fast_cb, NULL);
+	ASSERT_TRUE(ret);
+	ret = sensord_start(handle, 0);
+	ASSERT_TRUE(ret);
+
+	g_timeout_add(1000, stop_mainloop, NULL);
+	mainloop::run();
+
+	sensord_stop(handle);
+	sensord_unregister_event(handle, 1);
+	sensord_disconnect(handle);
+
+	ASSERT_TRUE(get_copy_stats(&delivered[1], &copied[1]));
+
+	/* [TEST] at most one copy of a sample per delivery */
+	ASSERT_GT(delivered[1], delivered[0]);
+	ASSERT_LE(copied[1] - copied[0], delivered[1] - delivered[0]);
+
+	return true;
+}
+
+TESTCASE(sensor_listener, queue_policy_p_1)
+{
+	int err;
+	bool ret;
+	int handle;
+	int value;
+	sensor_t sensor;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	handle = sensord_connect(sensor);
+
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_QUEUE_POLICY, SENSORD_QUEUE_LATEST_ONLY);
+	ASSERT_EQ(err, 0);
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_QUEUE_SIZE, 4);
+	ASSERT_EQ(err, 0);
+
+	/* [TEST] invalid policies and the read-only drop counter are rejected */
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_QUEUE_POLICY, -1);
+	ASSERT_LT(err, 0);
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_DROPPED_EVENTS, 0);
+	ASSERT_LT(err, 0);
+
+	ret = sensord_register_event(handle, 1, 10, 0, fast_cb, NULL);
+	ASSERT_TRUE(ret);
+	ret = sensord_start(handle, 0);
+	ASSERT_TRUE(ret);
+
+	g_timeout_add(1000, stop_mainloop, NULL);
+	mainloop::run();
+
+	err = sensord_listener_get_attribute_int(handle, SENSORD_ATTRIBUTE_QUEUE_POLICY, &value);
+	ASSERT_EQ(err, 0);
+	ASSERT_EQ(value, SENSORD_QUEUE_LATEST_ONLY);
+	err = sensord_listener_get_attribute_int(handle, SENSORD_ATTRIBUTE_QUEUE_SIZE, &value);
+	ASSERT_EQ(err, 0);
+	ASSERT_EQ(value, 4);
+
+	/* [TEST] the drop counter is readable */
+	err = sensord_listener_get_attribute_int(handle, SENSORD_ATTRIBUTE_DROPPED_EVENTS, &value);
+	ASSERT_EQ(err, 0);
+	ASSERT_GE(value, 0);
+
+	sensord_stop(handle);
+	sensord_unregister_event(handle, 1);
+	sensord_disconnect(handle);
+
+	return true;
+}
+
+#define FREEZE_INTERVAL_MS 10
+/* long enough for the samples to overflow the socket buffer (128KB) of the client */
+#define FREEZE_DURATION_MS 20000
+
+static std::vector<unsigned long long> held_timestamps;
+
+static void held_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+	held_timestamps.push_back(data->timestamp);
+}
+
+TESTCASE(sensor_listener, frozen_client_hold_p_1)
+{
+	int err;
+	bool ret;
+	int handle;
+	int dropped = -1;
+	sensor_t sensor;
+
+	held_timestamps.clear();
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	handle = sensord_connect(sensor);
+
+	/* the server queue is full as soon as the socket is */
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_QUEUE_SIZE, 1);
+	ASSERT_EQ(err, 0);
+
+	ret = sensord_register_event(handle, 1, FREEZE_INTERVAL_MS, 0, held_cb, NULL);
+	ASSERT_TRUE(ret);
+	ret = sensord_start(handle, 0);
+	ASSERT_TRUE(ret);
+
+	/* the client does not read its socket while the mainloop is not running */
+	usleep(FREEZE_DURATION_MS * 1000);
+
+	/* the held samples follow once the socket drains */
+	g_timeout_add(3000, stop_mainloop, NULL);
+	mainloop::run();
+
+	err = sensord_listener_get_attribute_int(handle, SENSORD_ATTRIBUTE_DROPPED_EVENTS, &dropped);
+
+	sensord_stop(handle);
+	sensord_unregister_event(handle, 1);
+	sensord_disconnect(handle);
+
+	ASSERT_EQ(err, 0);
+
+	/* [TEST] nothing was dropped while the client was frozen */
+	ASSERT_EQ(dropped, 0);
+	ASSERT_GE(held_timestamps.size(), (size_t)(FREEZE_DURATION_MS / FREEZE_INTERVAL_MS / 2));
+
+	/* [TEST] every sample arrived in order, without holes */
+	for (size_t i = 1; i < held_timestamps.size(); ++i) {
+		ASSERT_GT(held_timestamps[i], held_timestamps[i - 1]);
+		ASSERT_LT(held_timestamps[i] - held_timestamps[i - 1], FREEZE_INTERVAL_MS * 10000ULL);
+	}
+
+	return true;
+}
+
+#define FANOUT_LISTENERS 64
+#define FANOUT_DURATION_MS 3000
+
+struct delivery_latency {
+	unsigned long long total;
+	unsigned long long count;
+};
+
+static void latency_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+	delivery_latency *latency = (delivery_latency *)user_data;
+	unsigned long long now = sensor::utils::get_timestamp();
+
+	if (now < data->timestamp)
+		return;
+
+	latency->total += now - data->timestamp;
+	latency->count++;
+}
+
+TESTCASE(sensor_listener, deadline_fanout_latency_p_1)
+{
+	int err;
+	bool ret;
+	int urgent;
+	int background[FANOUT_LISTENERS];
+	sensor_t sensor;
+	delivery_latency urgent_latency = {0, 0};
+	delivery_latency background_latency = {0, 0};
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	/* background listeners connect first, so observer order alone would serve them first */
+	for (int i = 0; i < FANOUT_LISTENERS; ++i) {
+		background[i] = sensord_connect(sensor);
+		ret = sensord_register_event(background[i], 1, 10, 0, latency_cb, &background_latency);
+		ASSERT_TRUE(ret);
+		ret = sensord_start(background[i], 0);
+		ASSERT_TRUE(ret);
+	}
+
+	urgent = sensord_connect(sensor);
+	err = sensord_listener_set_attribute_int(urgent, SENSORD_ATTRIBUTE_DELIVERY_DEADLINE, 5);
+	ASSERT_EQ(err, 0);
+	ret = sensord_register_event(urgent, 1, 10, 0, latency_cb, &urgent_latency);
+	ASSERT_TRUE(ret);
+	ret = sensord_start(urgent, 0);
+	ASSERT_TRUE(ret);
+
+	g_timeout_add(FANOUT_DURATION_MS, stop_mainloop, NULL);
+	mainloop::run();
+
+	sensord_stop(urgent);
+	sensord_unregister_event(urgent, 1);
+	sensord_disconnect(urgent);
+
+	for (int i = 0; i < FANOUT_LISTENERS; ++i) {
+		sensord_stop(background[i]);
+		sensord_unregister_event(background[i], 1);
+		sensord_disconnect(background[i]);
+	}
+
+	ASSERT_GT(urgent_latency.count, 0);
+	ASSERT_GT(background_latency.count, 0);
+
+	unsigned long long urgent_mean = urgent_latency.total / urgent_latency.count;
+	unsigned long long background_mean = background_latency.total / background_latency.count;
+
+	_I("Delivery latency with %d background listeners : deadline %lluus, background %lluus\n",
+			FANOUT_LISTENERS, urgent_mean, background_mean);
+
+	/* [TEST] the listener with a deadline is not kept behind the fan-out */
+	ASSERT_LE(urgent_mean, background_mean);
+
+	return true;
+}
+
+static int on_change_count;
+
+static void on_change_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+	on_change_count++;
+}
+
+TESTCASE(sensor_listener, change_threshold_p_1)
+{
+	int err;
+	bool ret;
+	int handle;
+	sensor_t sensor;
+
+	on_change_count = 0;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	handle = sensord_connect(sensor);
+
+	/* 1000 m/s^2, no accelerometer sample moves that far */
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_REPORT_MODE, SENSORD_REPORT_ON_CHANGE);
+	ASSERT_EQ(err, 0);
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_ABS_THRESHOLD, 1000000);
+	ASSERT_EQ(err, 0);
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_REL_THRESHOLD, -1);
+	ASSERT_LT(err, 0);
+
+	ret = sensord_register_event(handle, 1, 10, 0, on_change_cb, NULL);
+	ASSERT_TRUE(ret);
+	ret = sensord_start(handle, 0);
+	ASSERT_TRUE(ret);
+
+	g_timeout_add(1000, stop_mainloop, NULL);
+	mainloop::run();
+
+	/* [TEST] only the first sample is reported, the rest stay under the threshold */
+	ASSERT_GT(on_change_count, 0);
+	ASSERT_LE(on_change_count, 2);
+
+	int reported = on_change_count;
+
+	ret = sensord_change_event_interval(handle, 1, 20);
+	ASSERT_TRUE(ret);
+
+	g_timeout_add(500, stop_mainloop, NULL);
+	mainloop::run();
+
+	/* [TEST] a new interval does not start the change filter over */
+	ASSERT_EQ(on_change_count, reported);
+
+	sensord_stop(handle);
+	sensord_unregister_event(handle, 1);
+	sensord_disconnect(handle);
+
+	return true;
+}
+
+#define AGGREGATION_WINDOW_MS 200
+
+static int summary_count;
+static bool summary_valid;
+
+static void summary_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+	summary_count++;
+
+	/* mean x, y, z followed by max x, y, z */
+	if (data->value_count != 6) {
+		summary_valid = false;
+		return;
+	}
+
+	for (int i = 0; i < 3; ++i) {
+		if (data->values[i] > data->values[i + 3])
+			summary_valid = false;
+	}
+}
+
+TESTCASE(sensor_listener, aggregation_p_1)
+{
+	int err;
+	bool ret;
+	int handle;
+	sensor_t sensor;
+
+	summary_count = 0;
+	summary_valid = true;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	handle = sensord_connect(sensor);
+
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_AGGREGATION,
+			SENSORD_AGGREGATION_MEAN | SENSORD_AGGREGATION_MAX);
+	ASSERT_EQ(err, 0);
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_AGGREGATION_WINDOW, AGGREGATION_WINDOW_MS);
+	ASSERT_EQ(err, 0);
+
+	ret = sensord_register_event(handle, 1, 10, 0, summary_cb, NULL);
+	ASSERT_TRUE(ret);
+	ret = sensord_start(handle, 0);
+	ASSERT_TRUE(ret);
+
+	g_timeout_add(1000, stop_mainloop, NULL);
+	mainloop::run();
+
+	/* [TEST] one summary per window instead of every sample */
+	ASSERT_GT(summary_count, 0);
+	ASSERT_LE(summary_count, 1000 / AGGREGATION_WINDOW_MS + 1);
+	ASSERT_TRUE(summary_valid);
+
+	sensord_stop(handle);
+	sensord_unregister_event(handle, 1);
+	sensord_disconnect(handle);
+
+	return true;
+}
+
+static std::map<unsigned long long, sensor_data_t> device_samples;
+static int remap_matches;
+static int remap_mismatches;
+
+static void device_oriented_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+	device_samples[data->timestamp] = *data;
+}
+
+static void display_oriented_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+	auto it = device_samples.find(data->timestamp);
+	if (it == device_samples.end())
+		return;
+
+	const sensor_data_t &device = it->second;
+	float device_xy = device.values[0] * device.values[0] + device.values[1] * device.values[1];
+	float display_xy = data->values[0] * data->values[0] + data->values[1] * data->values[1];
+
+	/* a rotation in the display plane keeps z and the length of (x, y) */
+	if (device.values[2] == data->values[2] && fabsf(device_xy - display_xy) < 0.001f)
+		remap_matches++;
+	else
+		remap_mismatches++;
+}
+
+TESTCASE(sensor_listener, axis_remap_p_1)
+{
+	int err;
+	bool ret;
+	int device, display;
+	int orientation = 0;
+	sensor_t sensor;
+
+	device_samples.clear();
+	remap_matches = 0;
+	remap_mismatches = 0;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	/* [TEST] a listener is not remapped unless it asks for it */
+	device = sensord_connect(sensor);
+	err = sensord_listener_get_attribute_int(device, SENSORD_ATTRIBUTE_AXIS_ORIENTATION, &orientation);
+	ASSERT_EQ(err, 0);
+	ASSERT_EQ(orientation, SENSORD_AXIS_DEVICE_ORIENTED);
+	ret = sensord_register_event(device, 1, 100, 0, device_oriented_cb, NULL);
+	ASSERT_TRUE(ret);
+
+	display = sensord_connect(sensor);
+	err = sensord_listener_set_attribute_int(display, SENSORD_ATTRIBUTE_AXIS_ORIENTATION, SENSORD_AXIS_DISPLAY_ORIENTED);
+	ASSERT_EQ(err, 0);
+	ret = sensord_register_event(display, 1, 100, 0, display_oriented_cb, NULL);
+	ASSERT_TRUE(ret);
+
+	ret = sensord_start(device, 0);
+	ASSERT_TRUE(ret);
+	ret = sensord_start(display, 0);
+	ASSERT_TRUE(ret);
+
+	g_timeout_add(1000, stop_mainloop, NULL);
+	mainloop::run();
+
+	sensord_stop(display);
+	sensord_stop(device);
+	sensord_unregister_event(display, 1);
+	sensord_unregister_event(device, 1);
+	sensord_disconnect(display);
+	sensord_disconnect(device);
+
+	/* [TEST] display oriented samples are device samples rotated in the display plane */
+	ASSERT_GT(remap_matches, 0);
+	ASSERT_EQ(remap_mismatches, 0);
+
+	return true;
+}
+
+static std::map<unsigned long long, sensor_data_t> filtered_samples;
+static int filter_matches;
+static int filter_mismatches;
+
+static void filtered_first_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+	filtered_samples[data->timestamp] = *data;
+}
+
+static void filtered_second_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+	auto it = filtered_samples.find(data->timestamp);
+	if (it == filtered_samples.end())
+		return;
+
+	if (memcmp(it->second.values, data->values, sizeof(data->values)) == 0)
+		filter_matches++;
+	else
+		filter_mismatches++;
+}
+
+TESTCASE(sensor_listener, shared_filter_p_1)
+{
+	int err;
+	bool ret;
+	int handle[2];
+	sensor_t sensor;
+	sensor_cb_t cb[2] = {filtered_first_cb, filtered_second_cb};
+
+	filtered_samples.clear();
+	filter_matches = 0;
+	filter_mismatches = 0;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	/* 1Hz low-pass, both listeners end up in the same group */
+	for (int i = 0; i < 2; ++i) {
+		handle[i] = sensord_connect(sensor);
+		err = sensord_listener_set_attribute_int(handle[i], SENSORD_ATTRIBUTE_FILTER, SENSORD_FILTER_LOW_PASS);
+		ASSERT_EQ(err, 0);
+		err = sensord_listener_set_attribute_int(handle[i], SENSORD_ATTRIBUTE_FILTER_CUTOFF, 1000);
+		ASSERT_EQ(err, 0);
+		ret = sensord_register_event(handle[i], 1, 10, 0, cb[i], NULL);
+		ASSERT_TRUE(ret);
+		ret = sensord_start(handle[i], 0);
+		ASSERT_TRUE(ret);
+	}
+
+	g_timeout_add(1000, stop_mainloop, NULL);
+	mainloop::run();
+
+	for (int i = 0; i < 2; ++i) {
+		sensord_stop(handle[i]);
+		sensord_unregister_event(handle[i], 1);
+		sensord_disconnect(handle[i]);
+	}
+
+	/* [TEST] members of a group receive the very same filtered samples */
+	ASSERT_GT(filter_matches, 0);
+	ASSERT_EQ(filter_mismatches, 0);
+
+	return true;
+}
+
+#define BIQUAD_SETTLE_US 500000ULL
+
+static unsigned long long biquad_first_timestamp;
+static int biquad_samples;
+static float biquad_max_gravity;
+
+static void biquad_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+	if (!biquad_first_timestamp)
+		biquad_first_timestamp = data->timestamp;
+	if (data->timestamp < biquad_first_timestamp + BIQUAD_SETTLE_US)
+		return;
+
+	biquad_samples++;
+	if (biquad_max_gravity < fabsf(data->values[2]))
+		biquad_max_gravity = fabsf(data->values[2]);
+}
+
+TESTCASE(sensor_listener, biquad_filter_p_1)
+{
+	int err;
+	bool ret;
+	int handle;
+	sensor_t sensor;
+
+	biquad_first_timestamp = 0;
+	biquad_samples = 0;
+	biquad_max_gravity = 0;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	handle = sensord_connect(sensor);
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_FILTER, SENSORD_FILTER_BIQUAD_HIGH_PASS + 1);
+	ASSERT_LT(err, 0);
+
+	/* 1Hz second order high-pass, it takes the constant gravity out of z */
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_FILTER, SENSORD_FILTER_BIQUAD_HIGH_PASS);
+	ASSERT_EQ(err, 0);
+	err = sensord_listener_set_attribute_int(handle, SENSORD_ATTRIBUTE_FILTER_CUTOFF, 1000);
+	ASSERT_EQ(err, 0);
+
+	ret = sensord_register_event(handle, 1, 10, 0, biquad_cb, NULL);
+	ASSERT_TRUE(ret);
+	ret = sensord_start(handle, 0);
+	ASSERT_TRUE(ret);
+
+	g_timeout_add(1500, stop_mainloop, NULL);
+	mainloop::run();
+
+	sensord_stop(handle);
+	sensord_unregister_event(handle, 1);
+	sensord_disconnect(handle);
+
+	/* [TEST] a device at rest reports no more than noise once the filter settled */
+	ASSERT_GT(biquad_samples, 0);
+	ASSERT_LT(biquad_max_gravity, 1.0f);
+
+	return true;
+}
+
+/* shared labels of the default configuration */
+static bool is_shared_label(const std::string &label)
+{
+	return label == "System" || label == "System::Privileged" || label == "User";
+}
+
+/*
+ * The server knows a client by its smack label, by the label and the pid for
+ * shared labels, or by its session without a label.
+ */
+static std::string get_budget_client(void)
+{
+	char label[256] = {0, };
+
+	FILE *fp = fopen("/proc/self/attr/current", "r");
+	if (fp) {
+		if (!fgets(label, sizeof(label), fp))
+			label[0] = '\0';
+		fclose(fp);
+	}
+
+	label[strcspn(label, "\n")] = '\0';
+	if (is_shared_label(label))
+		return std::string(label) + "/" + std::to_string(getpid());
+	if (label[0])
+		return label;
+
+	return "sid:" + std::to_string(getsid(0));
+}
+
+TESTCASE(sensor_listener, client_budget_stats_p_1)
+{
+	int err;
+	bool ret;
+	int handle;
+	int status;
+	pid_t pid;
+	sensor_t sensor;
+	char *stats = NULL;
+	int len = 0;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	handle = sensord_connect(sensor);
+	ret = sensord_register_event(handle, 1, 10, 0, fast_cb, NULL);
+	ASSERT_TRUE(ret);
+	ret = sensord_start(handle, 0);
+	ASSERT_TRUE(ret);
+
+	/* a child connecting on its own still counts against the same client,
+	 * unless the label is shared by unrelated platform processes */
+	pid = fork();
+	if (pid == 0) {
+		int child = sensord_connect(sensor);
+		sensord_start(child, 0);
+		usleep(1000000);
+		sensord_stop(child);
+		sensord_disconnect(child);
+		_exit(EXIT_SUCCESS);
+	}
+
+	g_timeout_add(500, stop_mainloop, NULL);
+	mainloop::run();
+
+	err = sensord_get_stats(SENSORD_STATS_CLIENT_BUDGET, &stats, &len);
+
+	bool shared = false;
+	if (err == 0) {
+		std::string client = get_budget_client();
+		bool per_process = (client.find('/') != std::string::npos);
+		std::string line = "\n" + client + (per_process ? " 1 " : " 2 ");
+		shared = (strstr(stats, line.c_str()) != NULL);
+		free(stats);
+	}
+
+	if (pid > 0)
+		waitpid(pid, &status, 0);
+
+	sensord_stop(handle);
+	sensord_unregister_event(handle, 1);
+	sensord_disconnect(handle);
+
+	ASSERT_GT(pid, 0);
+	ASSERT_EQ(err, 0);
+
+	/* [TEST] both processes share one budget line with two listeners,
+	 * or the parent has a line of its own under a shared label */
+	ASSERT_TRUE(shared);
+
+	return true;
+}
+
+TESTCASE(sensor_listener, data_snapshot_p_1)
+{
+	int err;
+	bool ret;
+	int again;
+	int handle[3];
+	sensor_t sensor[2];
+	sensor_data_t data[3];
+	sensor_data_t data_again[3];
+	sensor_data_t latest;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor[0]);
+	ASSERT_EQ(err, 0);
+	err = sensord_get_default_sensor(GYROSCOPE_SENSOR, &sensor[1]);
+	ASSERT_EQ(err, 0);
+
+	/* two listeners of one sensor and one of another */
+	handle[0] = sensord_connect(sensor[0]);
+	handle[1] = sensord_connect(sensor[0]);
+	handle[2] = sensord_connect(sensor[1]);
+
+	for (int i = 0; i < 3; ++i) {
+		ret = sensord_register_event(handle[i], 1, 10, 0, fast_cb, NULL);
+		ASSERT_TRUE(ret);
+		ret = sensord_start(handle[i], 0);
+		ASSERT_TRUE(ret);
+	}
+
+	g_timeout_add(500, stop_mainloop, NULL);
+	mainloop::run();
+
+	/* stopped sensors keep their samples and produce no new ones */
+	for (int i = 0; i < 3; ++i)
+		sensord_stop(handle[i]);
+
+	err = sensord_get_data_snapshot(handle, 3, data);
+	again = sensord_get_data_snapshot(handle, 3, data_again);
+	ret = sensord_get_data(handle[0], 0, &latest);
+
+	for (int i = 0; i < 3; ++i) {
+		sensord_unregister_event(handle[i], 1);
+		sensord_disconnect(handle[i]);
+	}
+
+	/* [TEST] every sensor returns its latest sample in one reply */
+	ASSERT_EQ(err, 3);
+
+	/* [TEST] a snapshot consumes nothing, neither for itself nor for get_data */
+	ASSERT_EQ(again, 3);
+	for (int i = 0; i < 3; ++i)
+		ASSERT_EQ(data_again[i].timestamp, data[i].timestamp);
+	ASSERT_TRUE(ret);
+	ASSERT_GT(data[0].timestamp, 0);
+	ASSERT_GT(data[2].timestamp, 0);
+
+	/* [TEST] listeners of the same sensor read the same cached sample */
+	ASSERT_EQ(data[0].timestamp, data[1].timestamp);
+
+	/* [TEST] an unknown handle fails the whole request */
+	int invalid = -1;
+	err = sensord_get_data_snapshot(&invalid, 1, data);
+	ASSERT_EQ(err, -EINVAL);
+
+	return true;
+}
+
+static std::map<sensor_t, int> merged_counts;
+static unsigned long long merged_last;
+static int merged_reversals;
+
+static void merged_cb(sensor_t sensor, unsigned int event_type, sensor_data_t *data, void *user_data)
+{
+	if (data->timestamp < merged_last)
+		merged_reversals++;
+	merged_last = data->timestamp;
+	merged_counts[sensor]++;
+}
+
+TESTCASE(sensor_listener, merged_group_p_1)
+{
+	int err;
+	bool ret;
+	int handle[2];
+	int group;
+	sensor_t sensor[2];
+
+	merged_counts.clear();
+	merged_last = 0;
+	merged_reversals = 0;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor[0]);
+	ASSERT_EQ(err, 0);
+	err = sensord_get_default_sensor(GYROSCOPE_SENSOR, &sensor[1]);
+	ASSERT_EQ(err, 0);
+
+	for (int i = 0; i < 2; ++i) {
+		handle[i] = sensord_connect(sensor[i]);
+		ret = sensord_register_event(handle[i], 1, 10, 0, fast_cb, NULL);
+		ASSERT_TRUE(ret);
+	}
+
+	group = sensord_connect_group(handle, 2, 200, merged_cb, NULL);
+	ASSERT_GT(group, 0);
+
+	/* [TEST] a sensor can't be merged into two groups */
+	err = sensord_connect_group(handle, 1, 200, merged_cb, NULL);
+	ASSERT_EQ(err, -EBUSY);
+
+	for (int i = 0; i < 2; ++i) {
+		ret = sensord_start(handle[i], 0);
+		ASSERT_TRUE(ret);
+	}
+
+	g_timeout_add(1000, stop_mainloop, NULL);
+	mainloop::run();
+
+	err = sensord_disconnect_group(group);
+
+	for (int i = 0; i < 2; ++i) {
+		sensord_stop(handle[i]);
+		sensord_unregister_event(handle[i], 1);
+		sensord_disconnect(handle[i]);
+	}
+
+	ASSERT_EQ(err, 0);
+
+	/* [TEST] both sensors come through the group, tagged with their sensor */
+	ASSERT_GT(merged_counts[sensor[0]], 0);
+	ASSERT_GT(merged_counts[sensor[1]], 0);
+
+	/* [TEST] the merged stream never goes back in time */
+	ASSERT_EQ(merged_reversals, 0);
+
+	return true;
+}
+
+static int attr_changed_count;
+static int attr_changed_value;
+
+static void attr_changed_cb(sensor_t sensor, int attribute, int value, void *user_data)
+{
+	if (attribute != SENSORD_ATTRIBUTE_AXIS_ORIENTATION)
+		return;
+
+	attr_changed_count++;
+	attr_changed_value = value;
+}
+
+TESTCASE(sensor_listener, attribute_change_coalesce_p_1)
+{
+	int err;
+	bool ret;
+	int changer;
+	int subscriber;
+	sensor_t sensor;
+	const int changes = 8;
+
+	attr_changed_count = 0;
+	attr_changed_value = 0;
+
+	err = sensord_get_default_sensor(ACCELEROMETER_SENSOR, &sensor);
+	ASSERT_EQ(err, 0);
+
+	changer = sensord_connect(sensor);
+	subscriber = sensord_connect(sensor);
+
+	ret = sensord_register_attribute_int_changed_cb(subscriber, attr_changed_cb, NULL);
+	ASSERT_TRUE(ret);
+
+	/* a burst of changes, ending in the display oriented axis */
+	for (int i = 0; i < changes; ++i) {
+		err = sensord_listener_set_attribute_int(changer, SENSORD_ATTRIBUTE_AXIS_ORIENTATION,
+				(i % 2) ? SENSORD_AXIS_DISPLAY_ORIENTED : SENSORD_AXIS_DEVICE_ORIENTED);
+		ASSERT_EQ(err, 0);
+	}
+
+	g_timeout_add(500, stop_mainloop, NULL);
+	mainloop::run();
+
+	sensord_unregister_attribute_int_changed_cb(subscriber);
+	sensord_disconnect(subscriber);
+	sensord_disconnect(changer);
+
+	/* [TEST] the subscriber is told, never more often than the attribute changed */
+	ASSERT_GT(attr_changed_count, 0);
+	ASSERT_LE(attr_changed_count, changes);
+
+	/* [TEST] coalescing keeps the latest value */
+	ASSERT_EQ(attr_changed_value, SENSORD_AXIS_DISPLAY_ORIENTED);
+
+	return true;
+}
@@ -0,0 +1,101 @@
+/*
+ * sensorctl
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <vector>
+
+#include "shared/flight_recorder.h"
+
+#include "log.h"
+#include "test_bench.h"
+
+using namespace sensor;
+
+#define RECORDER_CAPACITY 8
+#define RECORDER_TEST_PATH "/tmp/sensorctl_flight_test.bin"
+
+TESTCASE(flight_recorder, wrap_p)
+{
+	std::vector<flight_record_t> records;
+	bool ret;
+
+	flight_recorder::set_capacity(RECORDER_CAPACITY);
+	flight_recorder::set_path(RECORDER_TEST_PATH);
+
+	/* ids 0 ~ 11, only the last 8 are kept */
+	for (int i = 0; i < RECORDER_CAPACITY + 4; ++i)
+		flight_recorder::record(FLIGHT_RECORD_COMMAND, i, i * 10, 0);
+
+	size_t count = 0;
+	ret = flight_recorder::dump(&count);
+	ASSERT_TRUE(ret);
+	ASSERT_EQ(count, (size_t)RECORDER_CAPACITY);
+
+	ret = flight_recorder::load(RECORDER_TEST_PATH, records);
+	unlink(RECORDER_TEST_PATH);
+	flight_recorder::set_capacity(0);
+
+	ASSERT_TRUE(ret);
+	ASSERT_EQ(records.size(), (size_t)RECORDER_CAPACITY);
+
+	/* [TEST] the dump is oldest first and in time order */
+	for (int i = 0; i < RECORDER_CAPACITY; ++i) {
+		ASSERT_EQ(records[i].type, (uint32_t)FLIGHT_RECORD_COMMAND);
+		ASSERT_EQ(records[i].id, i + 4);
+		ASSERT_EQ(records[i].a, (int64_t)(i + 4) * 10);
+		if (i > 0)
+			ASSERT_GE(records[i].time, records[i - 1].time);
+	}
+
+	return true;
+}
+
+TESTCASE(flight_recorder, disabled_p)
+{
+	size_t count = 0;
+
+	flight_recorder::set_capacity(0);
+
+	/* [TEST] recording is a no-op and there is nothing to dump */
+	flight_recorder::record(FLIGHT_RECORD_SAMPLE, 1, 1, 1);
+	ASSERT_FALSE(flight_recorder::dump(&count));
+	ASSERT_EQ(count, (size_t)0);
+
+	return true;
+}
+
+TESTCASE(flight_recorder, load_n)
+{
+	std::vector<flight_record_t> records;
+	const char garbage[] = "not a flight record";
+
+	FILE *fp = fopen(RECORDER_TEST_PATH, "wb");
+	ASSERT_NE(fp, (FILE *)NULL);
+	fwrite(garbage, sizeof(garbage), 1, fp);
+	fclose(fp);
+
+	bool ret = flight_recorder::load(RECORDER_TEST_PATH, records);
+	unlink(RECORDER_TEST_PATH);
+
+	/* [TEST] a file without the header is refused */
+	ASSERT_FALSE(ret);
+
+	return true;
+}
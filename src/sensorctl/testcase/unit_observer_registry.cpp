@@ -0,0 +1,125 @@
+/*
+ * sensorctl
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <time.h>
+#include <list>
+
+#include "shared/observer_registry.h"
+
+#include "log.h"
+#include "test_bench.h"
+
+using namespace sensor;
+
+#define NOTIFY_ROUNDS 100000
+
+class counting_observer {
+public:
+	counting_observer()
+	: count(0)
+	{ }
+
+	virtual ~counting_observer() {}
+
+	virtual void update(void)
+	{
+		count++;
+	}
+
+	unsigned long long count;
+};
+
+static unsigned long long now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+TESTCASE(observer_registry, modify_during_walk_p)
+{
+	observer_registry<counting_observer> registry;
+	counting_observer obs[4];
+	counting_observer late;
+
+	for (int i = 0; i < 4; ++i)
+		ASSERT_TRUE(registry.add(&obs[i]));
+	ASSERT_FALSE(registry.add(&obs[0]));
+
+	uint64_t generation = registry.get_generation();
+
+	/* the first observer removes the next one and adds another */
+	registry.for_each([&](counting_observer *ob) {
+		ob->update();
+		if (ob == &obs[0]) {
+			registry.remove(&obs[1]);
+			registry.add(&late);
+		}
+	});
+
+	/* [TEST] removed entries are skipped, added ones wait for the next walk */
+	ASSERT_EQ(obs[0].count, 1ULL);
+	ASSERT_EQ(obs[1].count, 0ULL);
+	ASSERT_EQ(obs[3].count, 1ULL);
+	ASSERT_EQ(late.count, 0ULL);
+	ASSERT_EQ(registry.size(), (size_t)4);
+	ASSERT_NE(registry.get_generation(), generation);
+
+	registry.for_each([](counting_observer *ob) { ob->update(); });
+
+	ASSERT_EQ(late.count, 1ULL);
+	ASSERT_FALSE(registry.contains(&obs[1]));
+
+	return true;
+}
+
+TESTCASE(observer_registry, notify_cost_p)
+{
+	static const int counts[] = {1, 10, 100, 1000};
+
+	for (int count : counts) {
+		std::vector<counting_observer> obs(count);
+		observer_registry<counting_observer> registry;
+		std::list<counting_observer *> list;
+
+		for (int i = 0; i < count; ++i) {
+			registry.add(&obs[i]);
+			list.push_back(&obs[i]);
+		}
+
+		unsigned long long start = now_ns();
+		for (int r = 0; r < NOTIFY_ROUNDS; ++r)
+			registry.for_each([](counting_observer *ob) { ob->update(); });
+		unsigned long long registry_ns = (now_ns() - start) / NOTIFY_ROUNDS;
+
+		start = now_ns();
+		for (int r = 0; r < NOTIFY_ROUNDS; ++r) {
+			for (auto it = list.begin(); it != list.end(); ++it)
+				(*it)->update();
+		}
+		unsigned long long list_ns = (now_ns() - start) / NOTIFY_ROUNDS;
+
+		_I("observers[%4d] notify : registry %lluns, list %lluns\n", count, registry_ns, list_ns);
+
+		/* [TEST] every observer was visited once per round in both */
+		ASSERT_EQ(obs[count - 1].count, 2ULL * NOTIFY_ROUNDS);
+	}
+
+	return true;
+}
@@ -0,0 +1,129 @@
+/*
+ * sensorctl
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+#include <pthread.h>
+#include <atomic>
+
+#include "shared/sensor_history.h"
+
+#include "log.h"
+#include "test_bench.h"
+
+using namespace sensor;
+
+#define HISTORY_DEPTH 16
+#define WRITER_SAMPLES 1000000
+
+static void fill(sensor_data_t *data, int count, unsigned long long timestamp)
+{
+	memset(data, 0, sizeof(sensor_data_t) * count);
+
+	for (int i = 0; i < count; ++i) {
+		data[i].timestamp = timestamp + i;
+		data[i].value_count = 1;
+		data[i].values[0] = timestamp + i;
+	}
+}
+
+TESTCASE(sensor_history, range_p)
+{
+	sensor_history history(HISTORY_DEPTH);
+	sensor_data_t samples[HISTORY_DEPTH * 2];
+	sensor_data_t out[HISTORY_DEPTH];
+	int count;
+
+	ASSERT_EQ(history.get_latest(out, 1), 0);
+
+	/* timestamps 100 ~ 131, only the last 16 are kept */
+	fill(samples, HISTORY_DEPTH * 2, 100);
+	history.push(samples, HISTORY_DEPTH * 2);
+	ASSERT_EQ(history.get_position(), (uint64_t)HISTORY_DEPTH * 2);
+
+	count = history.get_latest(out, 3);
+	ASSERT_EQ(count, 3);
+	ASSERT_EQ(out[0].timestamp, 129ULL);
+	ASSERT_EQ(out[2].timestamp, 131ULL);
+
+	/* [TEST] range in the middle of the ring */
+	count = history.get_range(120, 124, out, HISTORY_DEPTH);
+	ASSERT_EQ(count, 5);
+	ASSERT_EQ(out[0].timestamp, 120ULL);
+	ASSERT_EQ(out[4].timestamp, 124ULL);
+
+	/* [TEST] overwritten samples are not returned, open end is up to now */
+	count = history.get_range(0, 0, out, HISTORY_DEPTH);
+	ASSERT_EQ(count, HISTORY_DEPTH);
+	ASSERT_EQ(out[0].timestamp, 116ULL);
+
+	/* [TEST] the newest samples win when the output is too small */
+	count = history.get_range(100, 0, out, 4);
+	ASSERT_EQ(count, 4);
+	ASSERT_EQ(out[0].timestamp, 128ULL);
+
+	ASSERT_EQ(history.get_range(200, 0, out, HISTORY_DEPTH), 0);
+
+	return true;
+}
+
+static std::atomic<bool> writing;
+
+static void *write_samples(void *data)
+{
+	sensor_history *history = (sensor_history *)data;
+	sensor_data_t sample;
+
+	for (int i = 1; i <= WRITER_SAMPLES; ++i) {
+		fill(&sample, 1, i);
+		history->push(&sample, 1);
+	}
+
+	writing = false;
+	return NULL;
+}
+
+TESTCASE(sensor_history, concurrent_reader_p)
+{
+	sensor_history history(HISTORY_DEPTH);
+	sensor_data_t out[HISTORY_DEPTH];
+	pthread_t writer;
+	int reads = 0;
+
+	writing = true;
+	ASSERT_EQ(pthread_create(&writer, NULL, write_samples, &history), 0);
+
+	while (writing) {
+		int count = history.get_latest(out, HISTORY_DEPTH);
+
+		/* [TEST] readers never see a torn or reordered sample */
+		for (int i = 0; i < count; ++i) {
+			ASSERT_EQ((unsigned long long)out[i].values[0], out[i].timestamp);
+			if (i > 0)
+				ASSERT_LT(out[i - 1].timestamp, out[i].timestamp);
+		}
+		reads++;
+	}
+
+	pthread_join(writer, NULL);
+	_I("reads[%d] while writing %d samples\n", reads, WRITER_SAMPLES);
+
+	ASSERT_EQ(history.get_position(), (uint64_t)WRITER_SAMPLES);
+
+	return true;
+}
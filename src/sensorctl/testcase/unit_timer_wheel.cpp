@@ -0,0 +1,177 @@
+/*
+ * sensorctl
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "shared/event_loop.h"
+#include "shared/timer_wheel.h"
+
+#include "log.h"
+#include "test_bench.h"
+
+using namespace ipc;
+
+#define TIMER_COUNT 500
+#define BENCH_DURATION 3000 /* ms */
+
+static int expirations;
+
+static void count_cb(uint64_t id, void *data)
+{
+	expirations++;
+}
+
+static bool run_timers(unsigned int slack, uint64_t *wakeups)
+{
+	event_loop eloop;
+	timer_wheel wheel(slack);
+
+	expirations = 0;
+	srand(0);
+
+	ASSERT_TRUE(wheel.attach(&eloop));
+
+	/* 500 periodic timers between 100ms and 1s like batch latencies */
+	for (int i = 0; i < TIMER_COUNT; ++i)
+		ASSERT_NE(wheel.add_timer(100 + rand() % 900, true, count_cb, NULL), 0);
+
+	eloop.run(BENCH_DURATION);
+
+	*wakeups = wheel.get_wakeup_count();
+	_I("slack[%ums] timers[%d] expirations[%d] wakeups[%llu]\n",
+			slack, TIMER_COUNT, expirations, (unsigned long long)*wakeups);
+
+	return true;
+}
+
+static int fired;
+
+static void oneshot_cb(uint64_t id, void *data)
+{
+	fired++;
+}
+
+TESTCASE(timer_wheel, oneshot_timer_p)
+{
+	event_loop eloop;
+	timer_wheel wheel(10);
+
+	fired = 0;
+
+	ASSERT_TRUE(wheel.attach(&eloop));
+
+	uint64_t id = wheel.add_timer(50, false, oneshot_cb, NULL);
+	ASSERT_NE(id, 0);
+	ASSERT_NE(wheel.add_timer(100, false, oneshot_cb, NULL), 0);
+	ASSERT_NE(wheel.add_timer(5000, false, oneshot_cb, NULL), 0);
+	ASSERT_NE(wheel.add_timer(200, false, oneshot_cb, NULL), 0);
+
+	/* [TEST] removed timer never fires */
+	ASSERT_TRUE(wheel.remove_timer(id));
+	ASSERT_FALSE(wheel.remove_timer(id));
+
+	eloop.run(1000);
+
+	ASSERT_EQ(fired, 2);
+	ASSERT_EQ(wheel.get_timer_count(), (size_t)1);
+
+	return true;
+}
+
+#define DEADLINE_TIMER_COUNT 50
+
+static int early;
+static int added;
+static uint64_t deadlines[DEADLINE_TIMER_COUNT];
+
+static uint64_t get_monotonic_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000;
+}
+
+static void deadline_cb(uint64_t id, void *data)
+{
+	uint64_t *deadline = (uint64_t *)data;
+
+	fired++;
+	if (get_monotonic_ms() < *deadline)
+		early++;
+}
+
+/* adds a one-shot timer at a random phase of a tick on every expiration */
+static void add_deadline_cb(uint64_t id, void *data)
+{
+	timer_wheel *wheel = (timer_wheel *)data;
+	unsigned int timeout = 1 + rand() % 50;
+
+	if (added == DEADLINE_TIMER_COUNT) {
+		wheel->remove_timer(id);
+		return;
+	}
+
+	usleep((rand() % wheel->get_slack()) * 1000);
+
+	deadlines[added] = get_monotonic_ms() + timeout;
+	if (wheel->add_timer(timeout, false, deadline_cb, &deadlines[added]))
+		added++;
+}
+
+TESTCASE(timer_wheel, never_early_p)
+{
+	event_loop eloop;
+	timer_wheel wheel(10);
+
+	fired = 0;
+	early = 0;
+	added = 0;
+	srand(0);
+
+	ASSERT_TRUE(wheel.attach(&eloop));
+	ASSERT_NE(wheel.add_timer(1, true, add_deadline_cb, &wheel), 0);
+
+	eloop.run(3000);
+
+	/* [TEST] every timer fired, none of them before its timeout */
+	ASSERT_EQ(added, DEADLINE_TIMER_COUNT);
+	ASSERT_EQ(fired, DEADLINE_TIMER_COUNT);
+	ASSERT_EQ(early, 0);
+
+	return true;
+}
+
+TESTCASE(timer_wheel, 500_timers_wakeup_count_p)
+{
+	uint64_t precise;
+	uint64_t coalesced;
+
+	ASSERT_TRUE(run_timers(1, &precise));
+	ASSERT_TRUE(run_timers(20, &coalesced));
+
+	/* [TEST] deadlines close together expire in one wakeup */
+	ASSERT_GT(expirations, 0);
+	ASSERT_LT(coalesced, (uint64_t)expirations);
+	ASSERT_LT(coalesced, precise);
+
+	return true;
+}
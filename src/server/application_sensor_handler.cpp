@@ -39,8 +39,7 @@ application_sensor_handler::~application_sensor_handler()
 
 int application_sensor_handler::publish(sensor_data_t *data, int len)
 {
-	std::string uri = m_info.get_uri();
-	return notify(uri.c_str(), data, len);
+	return notify(data, len);
 }
 
 const sensor_info &application_sensor_handler::get_sensor_info(void)
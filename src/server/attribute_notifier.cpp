@@ -0,0 +1,138 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "attribute_notifier.h"
+
+#include <string.h>
+#include <sensor_log.h>
+#include <message.h>
+
+#include "sensor_listener_proxy.h"
+
+using namespace sensor;
+
+attribute_notifier& attribute_notifier::get_instance(void)
+{
+	static attribute_notifier inst;
+	return inst;
+}
+
+attribute_notifier::attribute_notifier()
+: m_scheduled(false)
+{
+}
+
+void attribute_notifier::post(ipc::event_loop *loop, sensor_listener_proxy *proxy,
+		uint32_t id, int32_t attribute, int32_t value)
+{
+	cmd_listener_attr_int_t &change = m_pending[proxy].ints[attribute];
+
+	change.listener_id = id;
+	change.attribute = attribute;
+	change.value = value;
+
+	schedule(loop);
+}
+
+void attribute_notifier::post(ipc::event_loop *loop, sensor_listener_proxy *proxy,
+		uint32_t id, int32_t attribute, const char *value, int len)
+{
+	ret_if(len < 0);
+
+	std::vector<char> &change = m_pending[proxy].strs[attribute];
+
+	change.assign(ATTR_STR_RECORD_SIZE(len), 0);
+
+	cmd_listener_attr_str_t *record = reinterpret_cast<cmd_listener_attr_str_t *>(change.data());
+	record->listener_id = id;
+	record->attribute = attribute;
+	record->len = len;
+	memcpy(record->value, value, len);
+
+	schedule(loop);
+}
+
+void attribute_notifier::cancel(sensor_listener_proxy *proxy)
+{
+	m_pending.erase(proxy);
+}
+
+void attribute_notifier::schedule(ipc::event_loop *loop)
+{
+	ret_if(m_scheduled);
+
+	/* without a loop there is nothing to wait for, and the flush is queued along
+	 * with client commands, so that a busy loop cannot put it off */
+	if (!loop || !loop->add_idle_event(ipc::EVENT_PRIORITY_DEFAULT, idle_flush, this)) {
+		flush();
+		return;
+	}
+
+	m_scheduled = true;
+}
+
+void attribute_notifier::idle_flush(size_t id, void *data)
+{
+	attribute_notifier *notifier = reinterpret_cast<attribute_notifier *>(data);
+
+	notifier->m_scheduled = false;
+	notifier->flush();
+}
+
+void attribute_notifier::flush(void)
+{
+	std::unordered_map<sensor_listener_proxy *, changes> pending;
+
+	/* a listener may post again while it is notified */
+	pending.swap(m_pending);
+
+	for (auto it = pending.begin(); it != pending.end(); ++it) {
+		changes &c = it->second;
+
+		if (!c.ints.empty()) {
+			auto msg = ipc::message::create(c.ints.size() * sizeof(cmd_listener_attr_int_t));
+			if (msg) {
+				msg->set_type(CMD_LISTENER_SET_ATTR_INT);
+				for (auto &change : c.ints)
+					msg->append(&change.second, sizeof(cmd_listener_attr_int_t));
+
+				it->first->on_attribute_changed(msg);
+			} else {
+				_E("Failed to allocate memory");
+			}
+		}
+
+		if (!c.strs.empty()) {
+			size_t size = 0;
+			for (auto &change : c.strs)
+				size += change.second.size();
+
+			auto msg = ipc::message::create(size);
+			if (msg) {
+				msg->set_type(CMD_LISTENER_SET_ATTR_STR);
+				for (auto &change : c.strs)
+					msg->append(change.second.data(), change.second.size());
+
+				it->first->on_attribute_changed(msg);
+			} else {
+				_E("Failed to allocate memory");
+			}
+		}
+	}
+}
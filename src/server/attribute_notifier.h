@@ -0,0 +1,70 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __ATTRIBUTE_NOTIFIER_H__
+#define __ATTRIBUTE_NOTIFIER_H__
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+#include <unordered_map>
+#include <event_loop.h>
+#include <command_types.h>
+
+namespace sensor {
+
+class sensor_listener_proxy;
+
+/*
+ * Collects the attribute changes posted to listeners and sends them from
+ * an idle callback, so a burst of changes handled in one loop iteration
+ * reaches each listener as one message per attribute type. A later change
+ * of the same attribute replaces the pending one.
+ */
+class attribute_notifier {
+public:
+	static attribute_notifier& get_instance(void);
+
+	void post(ipc::event_loop *loop, sensor_listener_proxy *proxy,
+			uint32_t id, int32_t attribute, int32_t value);
+	void post(ipc::event_loop *loop, sensor_listener_proxy *proxy,
+			uint32_t id, int32_t attribute, const char *value, int len);
+	void cancel(sensor_listener_proxy *proxy);
+
+	void flush(void);
+
+private:
+	struct changes {
+		/* {attribute, change} */
+		std::map<int32_t, cmd_listener_attr_int_t> ints;
+		std::map<int32_t, std::vector<char>> strs;
+	};
+
+	attribute_notifier();
+
+	void schedule(ipc::event_loop *loop);
+	static void idle_flush(size_t id, void *data);
+
+	std::unordered_map<sensor_listener_proxy *, changes> m_pending;
+	bool m_scheduled;
+};
+
+}
+
+#endif /* __ATTRIBUTE_NOTIFIER_H__ */
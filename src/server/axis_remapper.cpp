@@ -0,0 +1,121 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "axis_remapper.h"
+
+#include <sensor_log.h>
+#include <command_types.h>
+
+#include "event_stats.h"
+
+using namespace sensor;
+
+axis_remapper::axis_remapper()
+: m_rotation(AUTO_ROTATION_DEGREE_0)
+, m_source_rotation(AUTO_ROTATION_DEGREE_UNKNOWN)
+{
+}
+
+axis_remapper& axis_remapper::get_instance(void)
+{
+	static axis_remapper remapper;
+	return remapper;
+}
+
+bool axis_remapper::is_remappable(sensor_type_t type)
+{
+	switch (type) {
+	case ACCELEROMETER_SENSOR:
+	case GYROSCOPE_SENSOR:
+	case GRAVITY_SENSOR:
+	case LINEAR_ACCEL_SENSOR:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void axis_remapper::set_display_rotation(int rotation)
+{
+	_I("Display rotation : %d", rotation);
+	m_rotation.store(rotation);
+}
+
+int axis_remapper::get_display_rotation(void)
+{
+	return m_rotation.load();
+}
+
+std::shared_ptr<ipc::message> axis_remapper::remap(std::shared_ptr<ipc::message> msg)
+{
+	int rotation = m_rotation.load();
+	size_t size = msg->size();
+
+	if (rotation != AUTO_ROTATION_DEGREE_90 &&
+			rotation != AUTO_ROTATION_DEGREE_180 &&
+			rotation != AUTO_ROTATION_DEGREE_270)
+		return msg;
+
+	if (size == 0 || size % sizeof(sensor_data_t))
+		return msg;
+
+	/* the other display oriented listeners of this event get the same copy */
+	if (m_remapped && m_source_rotation == rotation && m_source.lock() == msg)
+		return m_remapped;
+
+	auto remapped = ipc::message::create(size);
+	retvm_if(!remapped, msg, "Failed to allocate memory");
+
+	remapped->header()->type = msg->type();
+	remapped->header()->err = OP_SUCCESS;
+	remapped->append(msg->body(), size);
+
+	sensor_data_t *data = reinterpret_cast<sensor_data_t *>(remapped->body());
+	int count = size / sizeof(sensor_data_t);
+
+	for (int i = 0; i < count; ++i) {
+		float x, y;
+
+		switch (rotation) {
+		case AUTO_ROTATION_DEGREE_90:	/* Landscape Left */
+			x = -data[i].values[1];
+			y = data[i].values[0];
+			break;
+		case AUTO_ROTATION_DEGREE_180:	/* Portrait Bottom */
+			x = -data[i].values[0];
+			y = -data[i].values[1];
+			break;
+		default:	/* Landscape Right */
+			x = data[i].values[1];
+			y = -data[i].values[0];
+			break;
+		}
+
+		data[i].values[0] = x;
+		data[i].values[1] = y;
+	}
+
+	event_stats::copied(count, size);
+
+	m_source = msg;
+	m_source_rotation = rotation;
+	m_remapped = remapped;
+
+	return remapped;
+}
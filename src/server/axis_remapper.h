@@ -0,0 +1,59 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __AXIS_REMAPPER_H__
+#define __AXIS_REMAPPER_H__
+
+#include <atomic>
+#include <memory>
+#include <message.h>
+#include <sensor_types.h>
+
+namespace sensor {
+
+/*
+ * Turns device oriented samples into display oriented ones for the current
+ * display rotation. An event is remapped at most once, the result is shared
+ * by every display oriented listener of the sensor.
+ */
+class axis_remapper {
+public:
+	static axis_remapper& get_instance(void);
+
+	static bool is_remappable(sensor_type_t type);
+
+	void set_display_rotation(int rotation);
+	int get_display_rotation(void);
+
+	std::shared_ptr<ipc::message> remap(std::shared_ptr<ipc::message> msg);
+
+private:
+	axis_remapper();
+
+	std::atomic<int> m_rotation;
+
+	/* the last event remapped and its display oriented copy */
+	std::weak_ptr<ipc::message> m_source;
+	int m_source_rotation;
+	std::shared_ptr<ipc::message> m_remapped;
+};
+
+}
+
+#endif /* __AXIS_REMAPPER_H__ */
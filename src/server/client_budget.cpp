@@ -0,0 +1,187 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "client_budget.h"
+
+#include <stdio.h>
+#include <map>
+#include <set>
+#include <sensor_log.h>
+#include <sensor_utils.h>
+
+#define CLIENT_BUDGET_LINE_SIZE 256
+/* smack labels never contain a slash */
+#define CLIENT_PID_DELIMITER '/'
+
+using namespace sensor;
+
+struct budget_limit {
+	unsigned int rate;
+	unsigned int burst;
+};
+
+static budget_limit default_limit = {0, 0};
+
+/* {client, limit} */
+static std::map<std::string, budget_limit> limits;
+/* {client, budget} */
+static std::map<std::string, client_budget *> budgets;
+/* labels of the platform daemons, which would otherwise share one budget */
+static std::set<std::string> shared_labels = {"System", "System::Privileged", "User"};
+
+static budget_limit make_limit(unsigned int rate, unsigned int burst)
+{
+	/* at least a second worth of events */
+	budget_limit limit = {rate, burst > rate ? burst : rate};
+	return limit;
+}
+
+void client_budget::set_limit(unsigned int rate, unsigned int burst)
+{
+	default_limit = make_limit(rate, burst);
+
+	_I("Client budget : %u events/s, burst %u", default_limit.rate, default_limit.burst);
+}
+
+void client_budget::set_limit(const std::string &client, unsigned int rate, unsigned int burst)
+{
+	retm_if(client.empty(), "Invalid client");
+
+	budget_limit &limit = limits[client] = make_limit(rate, burst);
+
+	_I("Client budget of %s : %u events/s, burst %u", client.c_str(), limit.rate, limit.burst);
+}
+
+void client_budget::set_shared_labels(const std::string &labels)
+{
+	std::vector<std::string> tokens = sensor::utils::tokenize(labels, " ");
+
+	shared_labels.clear();
+	shared_labels.insert(tokens.begin(), tokens.end());
+
+	_I("Client budget shared labels : %s", labels.c_str());
+}
+
+std::string client_budget::get_client(const std::string &label, pid_t pid)
+{
+	retv_if(shared_labels.find(label) == shared_labels.end(), label);
+
+	return label + CLIENT_PID_DELIMITER + std::to_string(pid);
+}
+
+client_budget *client_budget::acquire(const std::string &client)
+{
+	auto it = budgets.find(client);
+	if (it != budgets.end()) {
+		it->second->m_refs++;
+		return it->second;
+	}
+
+	/* a process of a shared label falls back to the override of the label */
+	auto limit = limits.find(client);
+	if (limit == limits.end())
+		limit = limits.find(client.substr(0, client.find(CLIENT_PID_DELIMITER)));
+	const budget_limit &l = (limit != limits.end()) ? limit->second : default_limit;
+
+	client_budget *budget = new(std::nothrow) client_budget(client, l.rate, l.burst);
+	retvm_if(!budget, NULL, "Failed to allocate memory");
+
+	budgets[client] = budget;
+	return budget;
+}
+
+void client_budget::release(client_budget *budget)
+{
+	ret_if(!budget);
+	ret_if(--budget->m_refs > 0);
+
+	budgets.erase(budget->m_client);
+	delete budget;
+}
+
+void client_budget::get_stats(std::string &stats)
+{
+	char line[CLIENT_BUDGET_LINE_SIZE];
+
+	snprintf(line, sizeof(line), "rate %u events/s, burst %u%s, %zu overrides\n",
+			default_limit.rate, default_limit.burst,
+			default_limit.rate ? "" : " (disabled)", limits.size());
+	stats.append(line);
+	stats.append("client listeners rate burst tokens delivered throttled\n");
+
+	for (auto it = budgets.begin(); it != budgets.end(); ++it) {
+		client_budget *budget = it->second;
+
+		budget->refill();
+		snprintf(line, sizeof(line), "%s %d %u %u %.0f %llu %llu\n",
+				budget->m_client.c_str(), budget->m_refs,
+				budget->m_rate, budget->m_burst, budget->m_tokens,
+				budget->m_delivered, budget->m_throttled);
+		stats.append(line);
+	}
+}
+
+client_budget::client_budget(const std::string &client, unsigned int rate, unsigned int burst)
+: m_client(client)
+, m_rate(rate)
+, m_burst(burst)
+, m_refs(1)
+, m_tokens(burst)
+, m_refilled(sensor::utils::get_timestamp())
+, m_delivered(0)
+, m_throttled(0)
+{
+}
+
+bool client_budget::is_limited(void)
+{
+	return m_rate > 0;
+}
+
+bool client_budget::consume(unsigned int events)
+{
+	if (m_rate == 0) {
+		m_delivered += events;
+		return true;
+	}
+
+	refill();
+
+	if (m_tokens < events) {
+		m_throttled += events;
+		return false;
+	}
+
+	m_tokens -= events;
+	m_delivered += events;
+	return true;
+}
+
+void client_budget::refill(void)
+{
+	unsigned long long now = sensor::utils::get_timestamp();
+
+	if (now > m_refilled) {
+		m_tokens += (double)(now - m_refilled) * m_rate / 1000000;
+		if (m_tokens > m_burst)
+			m_tokens = m_burst;
+	}
+
+	m_refilled = now;
+}
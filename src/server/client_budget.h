@@ -0,0 +1,74 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __CLIENT_BUDGET_H__
+#define __CLIENT_BUDGET_H__
+
+#include <sys/types.h>
+#include <string>
+
+namespace sensor {
+
+/*
+ * Token bucket on the events delivered to one client, shared by all of its
+ * listeners. A client is its smack label, so that every process of an
+ * application shares one budget. Platform labels that many daemons run with
+ * are shared labels, and each process with one of them is a client of its
+ * own. Tokens come back at the client's rate up to
+ * its burst size, and samples finding the bucket empty are skipped, which
+ * decimates a greedy client down to its share without touching the others.
+ */
+class client_budget {
+public:
+	/* events per second and bucket size, a rate of 0 disables budgets */
+	static void set_limit(unsigned int rate, unsigned int burst);
+	/* overrides the default for one client, a rate of 0 exempts it,
+	 * the override of a shared label applies to each of its processes */
+	static void set_limit(const std::string &client, unsigned int rate, unsigned int burst);
+
+	/* space separated smack labels, which are split into a client per process */
+	static void set_shared_labels(const std::string &labels);
+	static std::string get_client(const std::string &label, pid_t pid);
+
+	static client_budget *acquire(const std::string &client);
+	static void release(client_budget *budget);
+
+	static void get_stats(std::string &stats);
+
+	bool is_limited(void);
+	bool consume(unsigned int events);
+
+private:
+	client_budget(const std::string &client, unsigned int rate, unsigned int burst);
+
+	void refill(void);
+
+	std::string m_client;
+	unsigned int m_rate;
+	unsigned int m_burst;
+	int m_refs;
+	double m_tokens;
+	unsigned long long m_refilled;
+	unsigned long long m_delivered;
+	unsigned long long m_throttled;
+};
+
+}
+
+#endif /* __CLIENT_BUDGET_H__ */
@@ -19,6 +19,7 @@
 
 #include <sensor_log.h>
 #include "dbus_listener.h"
+#include "axis_remapper.h"
 
 #define HANDLE_GERROR(Err) \
 	do { \
@@ -41,7 +42,7 @@ static void rotation_signal_cb(GDBusConnection *conn, const gchar *sender,
 {
 	gint state;
 	g_variant_get(param, "(i)", &state);
-	//sensor_event_listener::get_instance().set_display_rotation(state);
+	sensor::axis_remapper::get_instance().set_display_rotation(state);
 }
 
 static void rotation_read_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
@@ -55,7 +56,7 @@ static void rotation_read_cb(GObject *source_object, GAsyncResult *res, gpointer
 	gint state;
 	g_variant_get(result, "(i)", &state);
 	g_variant_unref(result);
-	//sensor_event_listener::get_instance().set_display_rotation(state);
+	sensor::axis_remapper::get_instance().set_display_rotation(state);
 }
 
 dbus_listener::dbus_listener()
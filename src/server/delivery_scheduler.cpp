@@ -0,0 +1,111 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "delivery_scheduler.h"
+
+#include <algorithm>
+#include <sensor_log.h>
+#include <command_types.h>
+
+#include "event_stats.h"
+
+using namespace sensor;
+
+delivery_scheduler::delivery_scheduler()
+: m_hold(0)
+, m_seq(0)
+{
+}
+
+delivery_scheduler& delivery_scheduler::get_instance(void)
+{
+	static delivery_scheduler scheduler;
+	return scheduler;
+}
+
+void delivery_scheduler::hold(void)
+{
+	m_hold++;
+}
+
+void delivery_scheduler::release(void)
+{
+	ret_if(m_hold <= 0);
+
+	if (--m_hold == 0)
+		dispatch();
+}
+
+bool delivery_scheduler::submit(ipc::channel *ch, unsigned long long deadline,
+		std::shared_ptr<ipc::message> msg)
+{
+	retv_if(!ch || !msg, false);
+
+	if (m_hold == 0)
+		return send(ch, msg);
+
+	m_heap.push_back({deadline, m_seq++, ch, msg});
+	std::push_heap(m_heap.begin(), m_heap.end(), later);
+
+	return true;
+}
+
+void delivery_scheduler::cancel(ipc::channel *ch)
+{
+	auto it = std::remove_if(m_heap.begin(), m_heap.end(),
+			[ch](const delivery &d) { return d.ch == ch; });
+	ret_if(it == m_heap.end());
+
+	m_heap.erase(it, m_heap.end());
+	std::make_heap(m_heap.begin(), m_heap.end(), later);
+}
+
+/* std heaps keep the largest element on top, so the later one compares less */
+bool delivery_scheduler::later(const delivery &a, const delivery &b)
+{
+	if (a.deadline != b.deadline)
+		return a.deadline > b.deadline;
+
+	/* same deadline, first come first served */
+	return a.seq > b.seq;
+}
+
+bool delivery_scheduler::send(ipc::channel *ch, std::shared_ptr<ipc::message> msg)
+{
+	retv_if(!ch->is_connected(), false);
+	retv_if(!ch->send(msg), false);
+
+	if (msg->type() == CMD_LISTENER_EVENT)
+		event_stats::delivered(msg->size() / sizeof(sensor_data_t));
+
+	return true;
+}
+
+void delivery_scheduler::dispatch(void)
+{
+	while (!m_heap.empty()) {
+		std::pop_heap(m_heap.begin(), m_heap.end(), later);
+		delivery d = std::move(m_heap.back());
+		m_heap.pop_back();
+
+		send(d.ch, d.msg);
+	}
+
+	m_seq = 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __DELIVERY_SCHEDULER_H__
+#define __DELIVERY_SCHEDULER_H__
+
+#include <stdint.h>
+#include <vector>
+#include <memory>
+#include <channel.h>
+#include <message.h>
+
+namespace sensor {
+
+/*
+ * Orders outbound listener messages earliest deadline first across channels.
+ * While a sensor event is being dispatched the scheduler is held, so every
+ * listener's message is collected first and then written in deadline order.
+ */
+class delivery_scheduler {
+public:
+	static delivery_scheduler& get_instance(void);
+
+	void hold(void);
+	void release(void);
+
+	/* deadline is an absolute monotonic time in us, NO_DEADLINE is served last */
+	bool submit(ipc::channel *ch, unsigned long long deadline, std::shared_ptr<ipc::message> msg);
+	void cancel(ipc::channel *ch);
+
+	static const unsigned long long NO_DEADLINE = ~0ULL;
+
+private:
+	struct delivery {
+		unsigned long long deadline;
+		uint64_t seq;
+		ipc::channel *ch;
+		std::shared_ptr<ipc::message> msg;
+	};
+
+	delivery_scheduler();
+
+	static bool later(const delivery &a, const delivery &b);
+	bool send(ipc::channel *ch, std::shared_ptr<ipc::message> msg);
+	void dispatch(void);
+
+	std::vector<delivery> m_heap;
+	int m_hold;
+	uint64_t m_seq;
+};
+
+}
+
+#endif /* __DELIVERY_SCHEDULER_H__ */
@@ -0,0 +1,219 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "event_merger.h"
+
+#include <string.h>
+#include <algorithm>
+#include <sensor_log.h>
+#include <command_types.h>
+#include <event_loop.h>
+#include <timer_wheel.h>
+
+#include "delivery_scheduler.h"
+#include "event_stats.h"
+
+#define MAX_MERGED_EVENTS 64
+
+using namespace sensor;
+
+event_merger::event_merger(uint32_t id, ipc::channel *ch, int window)
+: m_id(id)
+, m_ch(ch)
+, m_window((unsigned long long)window * 1000)
+, m_seq(0)
+, m_newest(0)
+, m_timer(0)
+{
+	_I("Create group[%u] with window[%d ms]", m_id, window);
+}
+
+event_merger::~event_merger()
+{
+	disarm();
+	delivery_scheduler::get_instance().cancel(m_ch);
+
+	_I("Delete group[%u]", m_id);
+}
+
+uint32_t event_merger::get_id(void)
+{
+	return m_id;
+}
+
+std::vector<uint32_t> event_merger::get_members(void)
+{
+	std::vector<uint32_t> ids;
+
+	for (auto it = m_members.begin(); it != m_members.end(); ++it)
+		ids.push_back(it->first);
+
+	return ids;
+}
+
+void event_merger::add_member(uint32_t listener_id, int32_t sensor_id)
+{
+	m_members[listener_id] = {sensor_id, 0};
+}
+
+void event_merger::remove_member(uint32_t listener_id)
+{
+	m_members.erase(listener_id);
+
+	/* the remaining members may no longer wait for it */
+	drain(false);
+}
+
+bool event_merger::later(const entry &a, const entry &b)
+{
+	if (a.timestamp != b.timestamp)
+		return a.timestamp > b.timestamp;
+
+	return a.seq > b.seq;
+}
+
+void event_merger::push(uint32_t listener_id, std::shared_ptr<ipc::message> msg)
+{
+	auto it = m_members.find(listener_id);
+	ret_if(it == m_members.end());
+
+	/* only sample payloads can be merged */
+	size_t size = msg->size();
+	ret_if(size == 0 || size % sizeof(sensor_data_t));
+
+	const sensor_data_t *data = reinterpret_cast<sensor_data_t *>(msg->body());
+	int count = size / sizeof(sensor_data_t);
+
+	for (int i = 0; i < count; ++i) {
+		entry e;
+		e.timestamp = data[i].timestamp;
+		e.seq = m_seq++;
+		e.sensor_id = it->second.sensor_id;
+		memcpy(&e.data, &data[i], sizeof(sensor_data_t));
+
+		m_heap.push_back(e);
+		std::push_heap(m_heap.begin(), m_heap.end(), later);
+
+		if (e.timestamp > it->second.latest)
+			it->second.latest = e.timestamp;
+		if (e.timestamp > m_newest)
+			m_newest = e.timestamp;
+	}
+
+	event_stats::copied(count, count * sizeof(sensor_data_t));
+
+	drain(false);
+}
+
+/*
+ * The oldest of the members' newest timestamps. Every later sample of an
+ * active member is newer than this, so anything up to it is in order.
+ * Members quiet for longer than the window don't hold the stream back.
+ */
+unsigned long long event_merger::get_watermark(void)
+{
+	unsigned long long watermark = ~0ULL;
+
+	for (auto it = m_members.begin(); it != m_members.end(); ++it) {
+		if (m_newest - it->second.latest >= m_window)
+			continue;
+
+		watermark = std::min(watermark, it->second.latest);
+	}
+
+	return watermark;
+}
+
+void event_merger::drain(bool all)
+{
+	unsigned long long watermark = get_watermark();
+	std::shared_ptr<ipc::message> msg;
+
+	while (!m_heap.empty()) {
+		const entry &top = m_heap.front();
+		if (!all && top.timestamp > watermark && m_newest - top.timestamp < m_window)
+			break;
+
+		if (!msg) {
+			msg = ipc::message::create(MAX_MERGED_EVENTS * sizeof(cmd_listener_group_event_t));
+			if (!msg) {
+				_E("Failed to allocate memory");
+				break;
+			}
+
+			msg->header()->type = CMD_LISTENER_GROUP_EVENT;
+			msg->header()->err = OP_SUCCESS;
+		}
+
+		cmd_listener_group_event_t event;
+		event.sensor_id = top.sensor_id;
+		memcpy(&event.data, &top.data, sizeof(sensor_data_t));
+		msg->append(&event, sizeof(event));
+
+		std::pop_heap(m_heap.begin(), m_heap.end(), later);
+		m_heap.pop_back();
+
+		if (msg->size() >= MAX_MERGED_EVENTS * sizeof(cmd_listener_group_event_t)) {
+			delivery_scheduler::get_instance().submit(m_ch, delivery_scheduler::NO_DEADLINE, msg);
+			msg.reset();
+		}
+	}
+
+	if (msg)
+		delivery_scheduler::get_instance().submit(m_ch, delivery_scheduler::NO_DEADLINE, msg);
+
+	if (m_heap.empty())
+		disarm();
+	else
+		arm();
+}
+
+/* held samples go out once the window passes, even if no member reports again */
+void event_merger::arm(void)
+{
+	ret_if(m_timer);
+
+	ipc::event_loop *loop = m_ch ? m_ch->loop() : NULL;
+	ipc::timer_wheel *wheel = loop ? loop->get_timer_wheel() : NULL;
+	ret_if(!wheel);
+
+	m_timer = wheel->add_timer(m_window / 1000, false, window_timeout, this);
+	if (!m_timer)
+		_E("Failed to add window timer of group[%u]", m_id);
+}
+
+void event_merger::disarm(void)
+{
+	ret_if(!m_timer);
+
+	ipc::event_loop *loop = m_ch ? m_ch->loop() : NULL;
+	ipc::timer_wheel *wheel = loop ? loop->get_timer_wheel() : NULL;
+	if (wheel)
+		wheel->remove_timer(m_timer);
+
+	m_timer = 0;
+}
+
+void event_merger::window_timeout(uint64_t id, void *data)
+{
+	event_merger *merger = reinterpret_cast<event_merger *>(data);
+
+	merger->m_timer = 0;
+	merger->drain(true);
+}
@@ -0,0 +1,89 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __EVENT_MERGER_H__
+#define __EVENT_MERGER_H__
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+#include <memory>
+#include <channel.h>
+#include <message.h>
+#include <sensor_types.h>
+
+namespace sensor {
+
+/*
+ * Merges the events of a group of listeners into one stream ordered by
+ * timestamp. A sample is held until every active member has reported a
+ * newer one, but never longer than the reorder window, so a slow or
+ * stopped member only delays the stream by the window.
+ */
+class event_merger {
+public:
+	/* window is in ms */
+	event_merger(uint32_t id, ipc::channel *ch, int window);
+	~event_merger();
+
+	uint32_t get_id(void);
+	std::vector<uint32_t> get_members(void);
+
+	void add_member(uint32_t listener_id, int32_t sensor_id);
+	void remove_member(uint32_t listener_id);
+
+	void push(uint32_t listener_id, std::shared_ptr<ipc::message> msg);
+
+private:
+	struct member {
+		int32_t sensor_id;
+		unsigned long long latest;
+	};
+
+	struct entry {
+		unsigned long long timestamp;
+		uint64_t seq;
+		int32_t sensor_id;
+		sensor_data_t data;
+	};
+
+	static bool later(const entry &a, const entry &b);
+	static void window_timeout(uint64_t id, void *data);
+
+	unsigned long long get_watermark(void);
+	void drain(bool all);
+	void arm(void);
+	void disarm(void);
+
+	uint32_t m_id;
+	ipc::channel *m_ch;
+	unsigned long long m_window;
+
+	/* {listener id, member} */
+	std::map<uint32_t, member> m_members;
+
+	std::vector<entry> m_heap;
+	uint64_t m_seq;
+	unsigned long long m_newest;
+	uint64_t m_timer;
+};
+
+}
+
+#endif /* __EVENT_MERGER_H__ */
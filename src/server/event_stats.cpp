@@ -0,0 +1,69 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "event_stats.h"
+
+#include <stdio.h>
+#include <atomic>
+
+#define EVENT_STATS_LINE_SIZE 256
+
+using namespace sensor;
+
+static std::atomic<unsigned long long> acquired_samples(0);
+static std::atomic<unsigned long long> cached_samples(0);
+static std::atomic<unsigned long long> copied_samples(0);
+static std::atomic<unsigned long long> copied_bytes(0);
+static std::atomic<unsigned long long> delivered_samples(0);
+
+void event_stats::acquired(size_t samples)
+{
+	acquired_samples.fetch_add(samples, std::memory_order_relaxed);
+}
+
+void event_stats::cached(size_t samples)
+{
+	cached_samples.fetch_add(samples, std::memory_order_relaxed);
+}
+
+void event_stats::copied(size_t samples, size_t bytes)
+{
+	copied_samples.fetch_add(samples, std::memory_order_relaxed);
+	copied_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void event_stats::delivered(size_t samples)
+{
+	delivered_samples.fetch_add(samples, std::memory_order_relaxed);
+}
+
+void event_stats::get_stats(std::string &stats)
+{
+	char line[EVENT_STATS_LINE_SIZE];
+	unsigned long long delivered = delivered_samples.load();
+	unsigned long long copied = copied_samples.load();
+
+	stats.append("acquired cached delivered copied copied(bytes) copies/delivery\n");
+
+	snprintf(line, sizeof(line), "%llu %llu %llu %llu %llu %.3f\n",
+			acquired_samples.load(), cached_samples.load(), delivered,
+			copied, copied_bytes.load(),
+			delivered ? (double)copied / delivered : 0.0);
+	stats.append(line);
+}
@@ -0,0 +1,44 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __EVENT_STATS_H__
+#define __EVENT_STATS_H__
+
+#include <stddef.h>
+#include <string>
+
+namespace sensor {
+
+/*
+ * Counts sensor samples from acquisition to delivery and every copy made
+ * of them on the way, to check how many copies a delivery costs.
+ */
+class event_stats {
+public:
+	static void acquired(size_t samples);
+	static void cached(size_t samples);
+	static void copied(size_t samples, size_t bytes);
+	static void delivered(size_t samples);
+
+	static void get_stats(std::string &stats);
+};
+
+}
+
+#endif /* __EVENT_STATS_H__ */
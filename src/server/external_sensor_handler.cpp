@@ -50,10 +50,7 @@ int external_sensor_notifier::notify(void)
 	if (m_sensor->get_data(&data, &len) < 0)
 		return OP_ERROR;
 
-	/* TODO: pointer would be better */
-	sensor_info info = m_sensor->get_sensor_info();
-
-	return m_sensor->notify(info.get_uri().c_str(), data, len);
+	return m_sensor->notify(data, len);
 }
 
 external_sensor_handler::external_sensor_handler(const sensor_info &info,
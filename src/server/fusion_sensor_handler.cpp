@@ -36,31 +36,56 @@ fusion_sensor_handler::fusion_sensor_handler(const sensor_info &info,
 fusion_sensor_handler::~fusion_sensor_handler()
 {
 	m_required_sensors.clear();
+	m_required_index.clear();
 }
 
 void fusion_sensor_handler::add_required_sensor(uint32_t id, sensor_handler *sensor)
 {
-	sensor_info info = sensor->get_sensor_info();
-	m_required_sensors.emplace(info.get_uri(), required_sensor(id, sensor));
+	int32_t sensor_id = sensor->get_id();
+	retm_if(sensor_id < 0, "Sensor is not registered");
+
+	if ((size_t)sensor_id >= m_required_index.size())
+		m_required_index.resize(sensor_id + 1, -1);
+	ret_if(m_required_index[sensor_id] >= 0);
+
+	m_required_index[sensor_id] = m_required_sensors.size();
+	m_required_sensors.push_back(required_sensor(id, sensor));
 }
 
-int fusion_sensor_handler::update(const char *uri, std::shared_ptr<ipc::message> msg)
+int fusion_sensor_handler::update(int32_t id, std::shared_ptr<ipc::message> msg)
 {
 	retv_if(!m_sensor, -EINVAL);
+	retv_if(id < 0 || (size_t)id >= m_required_index.size(), OP_SUCCESS);
+	retv_if(m_required_index[id] < 0, OP_SUCCESS);
+
+	required_sensor &input = m_required_sensors[m_required_index[id]];
 
-	auto it = m_required_sensors.find(uri);
-	retv_if(it == m_required_sensors.end(), OP_SUCCESS);
+	sensor_data_t *samples = (sensor_data_t *)msg->body();
+	int size = msg->size();
+	int count = 1;
+
+	/* fusion plugins take one sample at a time */
+	if (size > (int)sizeof(sensor_data_t) && size % sizeof(sensor_data_t) == 0) {
+		count = size / sizeof(sensor_data_t);
+		size = sizeof(sensor_data_t);
+	}
 
-	if (m_sensor->update(it->second.id, (sensor_data_t *)msg->body(), msg->size()) < 0)
-		return OP_SUCCESS;
+	int ret = OP_SUCCESS;
 
-	sensor_data_t *data;
-	int len;
+	for (int i = 0; i < count; ++i) {
+		if (m_sensor->update(input.id, &samples[i], size) < 0)
+			continue;
 
-	if (m_sensor->get_data(&data, &len) < 0)
-		return OP_ERROR;
+		sensor_data_t *data;
+		int len;
+
+		if (m_sensor->get_data(&data, &len) < 0)
+			return OP_ERROR;
+
+		ret = notify(data, len);
+	}
 
-	return notify(m_info.get_uri().c_str(), data, len);
+	return ret;
 }
 
 const sensor_info &fusion_sensor_handler::get_sensor_info(void)
@@ -268,7 +293,7 @@ int fusion_sensor_handler::start_required_sensors(void)
 {
 	auto it = m_required_sensors.begin();
 	for (; it != m_required_sensors.end(); ++it) {
-		if (it->second.sensor->start(this) < 0)
+		if (it->sensor->start(this) < 0)
 			return OP_ERROR;
 	}
 
@@ -279,7 +304,7 @@ int fusion_sensor_handler::stop_required_sensors(void)
 {
 	auto it = m_required_sensors.begin();
 	for (; it != m_required_sensors.end(); ++it) {
-		if (it->second.sensor->stop(this) < 0)
+		if (it->sensor->stop(this) < 0)
 			return OP_ERROR;
 	}
 
@@ -290,7 +315,7 @@ int fusion_sensor_handler::set_interval_internal(int32_t interval)
 {
 	auto it = m_required_sensors.begin();
 	for (; it != m_required_sensors.end(); ++it) {
-		if (it->second.sensor->set_interval(this, interval) < 0)
+		if (it->sensor->set_interval(this, interval) < 0)
 			return OP_ERROR;
 	}
 
@@ -301,7 +326,7 @@ int fusion_sensor_handler::set_batch_latency_internal(int32_t latency)
 {
 	auto it = m_required_sensors.begin();
 	for (; it != m_required_sensors.end(); ++it) {
-		if (it->second.sensor->set_batch_latency(this, latency) < 0)
+		if (it->sensor->set_batch_latency(this, latency) < 0)
 			return OP_ERROR;
 	}
 
@@ -312,7 +337,7 @@ int fusion_sensor_handler::set_attribute_internal(int32_t attr, int32_t value)
 {
 	auto it = m_required_sensors.begin();
 	for (; it != m_required_sensors.end(); ++it) {
-		if (it->second.sensor->set_attribute(this, attr, value) < 0)
+		if (it->sensor->set_attribute(this, attr, value) < 0)
 			return OP_ERROR;
 	}
 
@@ -323,7 +348,7 @@ int fusion_sensor_handler::set_attribute_internal(int32_t attr, const char *valu
 {
 	auto it = m_required_sensors.begin();
 	for (; it != m_required_sensors.end(); ++it) {
-		if (it->second.sensor->set_attribute(this, attr, value, len) < 0)
+		if (it->sensor->set_attribute(this, attr, value, len) < 0)
 			return OP_ERROR;
 	}
 
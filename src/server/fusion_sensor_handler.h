@@ -23,6 +23,7 @@
 #include <message.h>
 #include <sensor_types.h>
 #include <unordered_map>
+#include <vector>
 
 #include "sensor_handler.h"
 #include "sensor_observer.h"
@@ -51,7 +52,7 @@ public:
 	void add_required_sensor(uint32_t id, sensor_handler *sensor);
 
 	/* subscriber */
-	int update(const char *uri, std::shared_ptr<ipc::message> msg);
+	int update(int32_t id, std::shared_ptr<ipc::message> msg);
 
 	/* sensor interface */
 	const sensor_info &get_sensor_info(void);
@@ -82,7 +83,8 @@ private:
 	int get_min_batch_latency(void);
 
 	fusion_sensor *m_sensor;
-	std::unordered_map<std::string, required_sensor> m_required_sensors;
+	std::vector<required_sensor> m_required_sensors;
+	std::vector<int> m_required_index; /* sensor id -> m_required_sensors, -1 if not required */
 
 	std::unordered_map<sensor_observer *, int> m_interval_map;
 	std::unordered_map<sensor_observer *, int> m_batch_latency_map;
@@ -19,81 +19,168 @@
 
 #include "sensor_event_handler.h"
 
+#include <stdlib.h>
+#include <string.h>
 #include <sensor_log.h>
 #include <sensor_utils.h>
-#include <algorithm>
 
-using namespace sensor;
+#include "event_stats.h"
+#include "delivery_scheduler.h"
 
-static std::vector<uint32_t> ids;
+using namespace sensor;
 
 sensor_event_handler::sensor_event_handler()
+: m_count(0)
+, m_wakeup(0)
 {
 }
 
+sensor_event_handler::~sensor_event_handler()
+{
+	for (auto it = m_table.begin(); it != m_table.end(); ++it)
+		delete *it;
+}
+
 void sensor_event_handler::add_sensor(physical_sensor_handler *sensor)
 {
 	ret_if(!sensor);
 
-	m_sensors.insert(sensor);
+	uint32_t id = sensor->get_hal_id();
+	if (id >= m_table.size())
+		m_table.resize(id + 1, NULL);
+	ret_if(m_table[id]);
+
+	dispatch_entry *entry = new(std::nothrow) dispatch_entry;
+	retm_if(!entry, "Failed to allocate memory");
+
+	entry->sensor = sensor;
+	entry->wakeup = 0;
+
+	m_table[id] = entry;
+	m_count++;
 }
 
 void sensor_event_handler::remove_sensor(physical_sensor_handler *sensor)
 {
 	ret_if(!sensor);
 
-	m_sensors.erase(sensor);
+	uint32_t id = sensor->get_hal_id();
+	ret_if(id >= m_table.size() || !m_table[id] || m_table[id]->sensor != sensor);
+
+	delete m_table[id];
+	m_table[id] = NULL;
+	m_count--;
 }
 
-bool sensor_event_handler::handle(int fd, ipc::event_condition condition, void **data)
+physical_sensor_handler *sensor_event_handler::get_any_sensor(void)
 {
-	sensor_info info;
-	sensor_data_t *sensor_data;
-	physical_sensor_handler *sensor;
-	int length = 0;
-	int remains;
+	for (auto it = m_table.begin(); it != m_table.end(); ++it) {
+		if (*it)
+			return (*it)->sensor;
+	}
 
-	retv_if(m_sensors.empty(), false);
+	return NULL;
+}
 
-	ids.clear();
+bool sensor_event_handler::handle(int fd, ipc::event_condition condition, void **data)
+{
+	retv_if(m_count == 0, false);
 
-	auto it = m_sensors.begin();
+	m_ids.clear();
+	m_wakeup++;
 
 	/* sensors using the same fd share read_fd in common.
-	 * so just call read_fd on the first sensor */
-	if ((*it)->read_fd(ids) < 0)
+	 * so just call read_fd on one of them */
+	if (get_any_sensor()->read_fd(m_ids) < 0)
 		return true;
 
-	for (; it != m_sensors.end(); ++it) {
-		remains = 1;
-		sensor = *it;
+	/* everything this wakeup produced competes on deadlines, not sensor order */
+	delivery_scheduler::get_instance().hold();
 
-		/* check whether the id of this sensor is in id list(parameter) or not */
-		auto result = std::find(std::begin(ids), std::end(ids), sensor->get_hal_id());
-		if (result == std::end(ids))
+	for (auto it = m_ids.begin(); it != m_ids.end(); ++it) {
+		if (*it >= m_table.size() || !m_table[*it])
 			continue;
 
-		while (remains > 0) {
-			remains = sensor->get_data(&sensor_data, &length);
-			if (remains < 0) {
-				_E("Failed to get sensor data");
-				break;
-			}
-
-			if (sensor->on_event(sensor_data, length, remains) < 0) {
-				free(sensor_data);
-				continue;
-			}
-
-			info = sensor->get_sensor_info();
-
-			//_I("[Data] allocate %p", sensor_data);
-			if (sensor->notify(info.get_uri().c_str(), sensor_data, length) < 0) {
-				free(sensor_data);
-			}
-			info.clear();
-		}
+		/* an id reported twice is drained once */
+		dispatch_entry *entry = m_table[*it];
+		if (entry->wakeup == m_wakeup)
+			continue;
+
+		entry->wakeup = m_wakeup;
+		drain(entry);
 	}
 
+	delivery_scheduler::get_instance().release();
+
 	return true;
 }
+
+/*
+ * Reads every sample the sensor has queued and hands them to the observers
+ * as one event, so a FIFO flush costs one notify instead of one per sample.
+ */
+void sensor_event_handler::drain(dispatch_entry *entry)
+{
+	physical_sensor_handler *sensor = entry->sensor;
+	sensor_data_t *sensor_data;
+	int length = 0;
+	int remains = 1;
+
+	while (remains > 0) {
+		remains = sensor->get_data(&sensor_data, &length);
+		if (remains < 0) {
+			_E("Failed to get sensor data");
+			break;
+		}
+
+		if (sensor->on_event(sensor_data, length, remains) < 0) {
+			free(sensor_data);
+			continue;
+		}
+
+		if (length == sizeof(sensor_data_t)) {
+			entry->pending.push_back(sensor_data);
+			continue;
+		}
+
+		/* other payloads go out as they are, after what came before them */
+		flush(entry);
+		if (sensor->notify(sensor_data, length) < 0)
+			free(sensor_data);
+	}
+
+	flush(entry);
+}
+
+void sensor_event_handler::flush(dispatch_entry *entry)
+{
+	size_t count = entry->pending.size();
+	ret_if(count == 0);
+
+	int length = count * sizeof(sensor_data_t);
+	sensor_data_t *sensor_data = entry->pending[0];
+
+	/* a single sample is passed on in the buffer the HAL gave,
+	 * several are gathered into one, which is their only copy */
+	if (count > 1) {
+		sensor_data = (sensor_data_t *)malloc(length);
+
+		for (size_t i = 0; i < count; ++i) {
+			if (sensor_data)
+				memcpy(&sensor_data[i], entry->pending[i], sizeof(sensor_data_t));
+			free(entry->pending[i]);
+		}
+
+		if (sensor_data)
+			event_stats::copied(count, length);
+	}
+
+	/* keeps its capacity for the next wakeup */
+	entry->pending.clear();
+
+	retm_if(!sensor_data, "Failed to allocate memory");
+
+	/* the message takes the buffer */
+	if (entry->sensor->notify(sensor_data, length) < 0)
+		free(sensor_data);
+}
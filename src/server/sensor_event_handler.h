@@ -21,7 +21,7 @@
 #define __SENSOR_EVENT_HANDLER__
 
 #include <event_handler.h>
-#include <set>
+#include <vector>
 
 #include "physical_sensor_handler.h"
 
@@ -31,6 +31,7 @@ class sensor_event_handler : public ipc::event_handler
 {
 public:
 	sensor_event_handler();
+	~sensor_event_handler();
 
 	void add_sensor(physical_sensor_handler *sensor);
 	void remove_sensor(physical_sensor_handler *sensor);
@@ -38,7 +39,22 @@ public:
 	bool handle(int fd, ipc::event_condition condition, void **data);
 
 private:
-	std::set<physical_sensor_handler *> m_sensors;
+	class dispatch_entry {
+	public:
+		physical_sensor_handler *sensor;
+		uint64_t wakeup;
+		std::vector<sensor_data_t *> pending;
+	};
+
+	physical_sensor_handler *get_any_sensor(void);
+	void drain(dispatch_entry *entry);
+	void flush(dispatch_entry *entry);
+
+	/* indexed by hal id */
+	std::vector<dispatch_entry *> m_table;
+	size_t m_count;
+	uint64_t m_wakeup;
+	std::vector<uint32_t> m_ids;
 };
 
 }
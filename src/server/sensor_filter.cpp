@@ -0,0 +1,206 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "sensor_filter.h"
+
+#include <math.h>
+#include <map>
+#include <tuple>
+#include <sensor_log.h>
+#include <command_types.h>
+
+#include "event_stats.h"
+
+/* a longer gap between samples starts the filter over */
+#define FILTER_RESET_GAP_US 1000000ULL
+
+/* Butterworth quality factor, 1 / sqrt(2) */
+#define BIQUAD_Q M_SQRT1_2
+/* keeps the cutoff under the Nyquist frequency of the sample rate */
+#define BIQUAD_MAX_WARP (0.49 * M_PI)
+
+using namespace sensor;
+
+typedef std::tuple<int32_t, int, int> filter_key;
+
+static std::map<filter_key, sensor_filter *> filters;
+
+sensor_filter *sensor_filter::acquire(int32_t sensor_id, int type, int cutoff)
+{
+	retv_if(type == SENSORD_FILTER_NONE || cutoff <= 0, NULL);
+
+	filter_key key(sensor_id, type, cutoff);
+	auto it = filters.find(key);
+	if (it != filters.end()) {
+		it->second->m_refs++;
+		return it->second;
+	}
+
+	sensor_filter *filter = new(std::nothrow) sensor_filter(sensor_id, type, cutoff);
+	retvm_if(!filter, NULL, "Failed to allocate memory");
+
+	filters[key] = filter;
+	return filter;
+}
+
+void sensor_filter::release(sensor_filter *filter)
+{
+	ret_if(!filter);
+	ret_if(--filter->m_refs > 0);
+
+	filters.erase(filter_key(filter->m_sensor_id, filter->m_type, filter->m_cutoff));
+	delete filter;
+}
+
+sensor_filter::sensor_filter(int32_t sensor_id, int type, int cutoff)
+: m_sensor_id(sensor_id)
+, m_type(type)
+, m_cutoff(cutoff)
+, m_refs(1)
+, m_rc(1000.0 / (2 * M_PI * cutoff))
+, m_primed(false)
+, m_timestamp(0)
+{
+}
+
+sensor_filter::~sensor_filter()
+{
+}
+
+std::shared_ptr<ipc::message> sensor_filter::apply(std::shared_ptr<ipc::message> msg)
+{
+	size_t size = msg->size();
+	if (size == 0 || size % sizeof(sensor_data_t))
+		return msg;
+
+	/* the other members of the group get the same filtered copy */
+	if (m_filtered && m_source.lock() == msg)
+		return m_filtered;
+
+	auto filtered = ipc::message::create(size);
+	retvm_if(!filtered, msg, "Failed to allocate memory");
+
+	filtered->header()->type = msg->type();
+	filtered->header()->err = OP_SUCCESS;
+	filtered->append(msg->body(), size);
+
+	sensor_data_t *data = reinterpret_cast<sensor_data_t *>(filtered->body());
+	int count = size / sizeof(sensor_data_t);
+
+	for (int i = 0; i < count; ++i)
+		filter(&data[i]);
+
+	event_stats::copied(count, size);
+
+	m_source = msg;
+	m_filtered = filtered;
+
+	return filtered;
+}
+
+bool sensor_filter::is_low_pass(void)
+{
+	return m_type == SENSORD_FILTER_LOW_PASS || m_type == SENSORD_FILTER_BIQUAD_LOW_PASS;
+}
+
+bool sensor_filter::is_biquad(void)
+{
+	return m_type == SENSORD_FILTER_BIQUAD_LOW_PASS || m_type == SENSORD_FILTER_BIQUAD_HIGH_PASS;
+}
+
+/* starts from the steady state of the first sample */
+void sensor_filter::prime(sensor_data_t *data, int count)
+{
+	for (int i = 0; i < count; ++i) {
+		m_input[i] = m_input2[i] = data->values[i];
+		m_output[i] = m_output2[i] = is_low_pass() ? data->values[i] : 0;
+		data->values[i] = m_output[i];
+	}
+
+	m_timestamp = data->timestamp;
+	m_primed = true;
+}
+
+void sensor_filter::filter(sensor_data_t *data)
+{
+	int count = data->value_count;
+	if (count < 0 || count > SENSOR_DATA_VALUE_SIZE)
+		count = SENSOR_DATA_VALUE_SIZE;
+
+	if (!m_primed || data->timestamp <= m_timestamp ||
+			data->timestamp - m_timestamp > FILTER_RESET_GAP_US) {
+		prime(data, count);
+		return;
+	}
+
+	double dt = (data->timestamp - m_timestamp) / 1000000.0;
+	m_timestamp = data->timestamp;
+
+	if (is_biquad()) {
+		filter_biquad(data, count, dt);
+		return;
+	}
+
+	for (int i = 0; i < count; ++i) {
+		float input = data->values[i];
+
+		if (m_type == SENSORD_FILTER_LOW_PASS)
+			m_output[i] += (dt / (m_rc + dt)) * (input - m_output[i]);
+		else
+			m_output[i] = (m_rc / (m_rc + dt)) * (m_output[i] + input - m_input[i]);
+
+		m_input[i] = input;
+		data->values[i] = m_output[i];
+	}
+}
+
+/*
+ * Direct form I with bilinear transformed Butterworth coefficients. They are
+ * derived from the interval of each sample, like the first order stage, so
+ * that jitter in the sample rate does not move the cutoff.
+ */
+void sensor_filter::filter_biquad(sensor_data_t *data, int count, double dt)
+{
+	double k = tan(fmin(M_PI * m_cutoff / 1000.0 * dt, BIQUAD_MAX_WARP));
+	double norm = 1 / (1 + k / BIQUAD_Q + k * k);
+	double b0, b1, b2;
+	double a1 = 2 * (k * k - 1) * norm;
+	double a2 = (1 - k / BIQUAD_Q + k * k) * norm;
+
+	if (is_low_pass()) {
+		b0 = k * k * norm;
+		b1 = 2 * b0;
+	} else {
+		b0 = norm;
+		b1 = -2 * b0;
+	}
+	b2 = b0;
+
+	for (int i = 0; i < count; ++i) {
+		float input = data->values[i];
+		float output = b0 * input + b1 * m_input[i] + b2 * m_input2[i] -
+				a1 * m_output[i] - a2 * m_output2[i];
+
+		m_input2[i] = m_input[i];
+		m_input[i] = input;
+		m_output2[i] = m_output[i];
+		m_output[i] = output;
+		data->values[i] = output;
+	}
+}
@@ -0,0 +1,75 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __SENSOR_FILTER_H__
+#define __SENSOR_FILTER_H__
+
+#include <stdint.h>
+#include <memory>
+#include <message.h>
+#include <sensor_types.h>
+
+namespace sensor {
+
+/*
+ * First or second order IIR stage shared by every listener of a sensor asking for the
+ * same filter. Each event is filtered once, and the filtered copy is handed
+ * to all members of the group.
+ */
+class sensor_filter {
+public:
+	/* cutoff is in mHz */
+	static sensor_filter *acquire(int32_t sensor_id, int type, int cutoff);
+	static void release(sensor_filter *filter);
+
+	std::shared_ptr<ipc::message> apply(std::shared_ptr<ipc::message> msg);
+
+private:
+	sensor_filter(int32_t sensor_id, int type, int cutoff);
+	~sensor_filter();
+
+	bool is_low_pass(void);
+	bool is_biquad(void);
+	void prime(sensor_data_t *data, int count);
+	void filter(sensor_data_t *data);
+	void filter_biquad(sensor_data_t *data, int count, double dt);
+
+	int32_t m_sensor_id;
+	int m_type;
+	int m_cutoff;
+	int m_refs;
+
+	/* RC time constant (s) of the cutoff */
+	double m_rc;
+	bool m_primed;
+	unsigned long long m_timestamp;
+	float m_input[SENSOR_DATA_VALUE_SIZE];
+	float m_output[SENSOR_DATA_VALUE_SIZE];
+
+	/* the samples before the last ones, for the biquad */
+	float m_input2[SENSOR_DATA_VALUE_SIZE];
+	float m_output2[SENSOR_DATA_VALUE_SIZE];
+
+	std::weak_ptr<ipc::message> m_source;
+	std::shared_ptr<ipc::message> m_filtered;
+};
+
+}
+
+#endif /* __SENSOR_FILTER_H__ */
@@ -19,12 +19,17 @@
 
 #include "sensor_handler.h"
 
+#include <algorithm>
 #include <message.h>
 #include <sensor_log.h>
 #include <sensor_utils.h>
 #include <sensor_types_private.h>
 #include <command_types.h>
 #include <sensor_listener_proxy.h>
+#include <flight_recorder.h>
+
+#include "event_stats.h"
+#include "delivery_scheduler.h"
 
 #define AUTO_ROTATION "http://tizen.org/sensor/general/auto_rotation/tizen_default"
 
@@ -32,9 +37,12 @@ using namespace sensor;
 
 sensor_handler::sensor_handler(const sensor_info &info)
 : m_info(info)
+, m_id(-1)
 , m_prev_interval(0)
 , m_prev_latency(0)
 , m_need_to_notify_attribute_changed(false)
+, m_last_count(0)
+, m_read_position(0)
 {
 	const char *priv = sensor::utils::get_privilege(m_info.get_uri());
 	m_info.set_privilege(priv);
@@ -58,20 +66,12 @@ sensor_handler::sensor_handler(const sensor_info &info)
 
 bool sensor_handler::has_observer(sensor_observer *ob)
 {
-	for (auto it = m_observers.begin(); it != m_observers.end(); ++it) {
-		if ((*it) == ob)
-			return true;
-	}
-
-	return false;
+	return m_observers.contains(ob);
 }
 
 bool sensor_handler::add_observer(sensor_observer *ob)
 {
-	retv_if(has_observer(ob), false);
-
-	m_observers.push_back(ob);
-	return true;
+	return m_observers.add(ob);
 }
 
 void sensor_handler::remove_observer(sensor_observer *ob)
@@ -79,8 +79,23 @@ void sensor_handler::remove_observer(sensor_observer *ob)
 	m_observers.remove(ob);
 }
 
-int sensor_handler::notify(const char *uri, sensor_data_t *data, int len)
+bool sensor_handler::add_passive_observer(sensor_observer *ob)
+{
+	return m_passive_observers.add(ob);
+}
+
+void sensor_handler::remove_passive_observer(sensor_observer *ob)
+{
+	m_passive_observers.remove(ob);
+}
+
+int sensor_handler::notify(sensor_data_t *data, int len)
 {
+	if (data && len > 0 && len % sizeof(sensor_data_t) == 0) {
+		int count = len / sizeof(sensor_data_t);
+		flight_recorder::record(FLIGHT_RECORD_SAMPLE, m_id, data[count - 1].timestamp, count);
+	}
+
 	if (observer_count() == 0)
 		return OP_ERROR;
 
@@ -88,8 +103,21 @@ int sensor_handler::notify(const char *uri, sensor_data_t *data, int len)
 
 	retvm_if(!msg, OP_ERROR, "Failed to allocate memory");
 
-	for (auto it = m_observers.begin(); it != m_observers.end(); ++it)
-		(*it)->update(uri, msg);
+	/* the same message goes to every observer and is not changed afterwards */
+	msg->header()->type = CMD_LISTENER_EVENT;
+	msg->header()->err = OP_SUCCESS;
+
+	event_stats::acquired(len / sizeof(sensor_data_t));
+
+	/* listeners are sent to in deadline order once all of them have the event */
+	delivery_scheduler::get_instance().hold();
+
+	/* an observer may stop or remove listeners from update() */
+	auto update = [this, &msg](sensor_observer *ob) { ob->update(m_id, msg); };
+	m_observers.for_each(update);
+	m_passive_observers.for_each(update);
+
+	delivery_scheduler::get_instance().release();
 
 	set_cache(data, len);
 
@@ -101,102 +129,144 @@ uint32_t sensor_handler::observer_count(void)
 	return m_observers.size();
 }
 
+void sensor_handler::add_attribute_listener(sensor_listener_proxy *proxy)
+{
+	m_attribute_listeners.add(proxy);
+}
+
+void sensor_handler::remove_attribute_listener(sensor_listener_proxy *proxy)
+{
+	m_attribute_listeners.remove(proxy);
+}
+
+int32_t sensor_handler::get_id(void)
+{
+	return m_id;
+}
+
+void sensor_handler::set_id(int32_t id)
+{
+	m_id = id;
+}
+
 void sensor_handler::set_cache(sensor_data_t *data, int size)
 {
+	if (size > 0 && size % sizeof(sensor_data_t) == 0) {
+		m_last_count = size / sizeof(sensor_data_t);
+		m_history.push(data, m_last_count);
+		event_stats::cached(m_last_count);
+		return;
+	}
+
+	/* other payloads keep only the last one, the buffer grows once to the largest size */
 	char* p = (char*) data;
 
 	try {
-		m_sensor_data_cache.reserve(size);
+		m_raw_cache.assign(p, p + size);
 	} catch (...) {
 		_E("Memory allocation failed");
 		return;
 	}
-	m_sensor_data_cache.clear();
-	m_sensor_data_cache.insert(m_sensor_data_cache.begin(), p, p + size);
+	m_last_count = 0;
 }
 
 int sensor_handler::get_cache(sensor_data_t **data, int *len)
 {
-	auto size = m_sensor_data_cache.size();
-	retv_if(size == 0, -ENODATA);
+	bool consume = (m_info.get_uri() != AUTO_ROTATION);
+
+	if (m_last_count == 0) {
+		auto size = m_raw_cache.size();
+		retv_if(size == 0, -ENODATA);
+
+		char* temp = (char *)malloc(size);
+		retvm_if(temp == NULL, -ENOMEM, "Memory allocation failed");
+		std::copy(m_raw_cache.begin(), m_raw_cache.end(), temp);
+
+		*len = size;
+		*data = (sensor_data_t *)temp;
+
+		if (consume)
+			m_raw_cache.clear();
 
-	char* temp = (char *)malloc(size);
+		return 0;
+	}
+
+	uint64_t position = m_history.get_position();
+	retv_if(consume && position == m_read_position, -ENODATA);
+
+	sensor_data_t *temp = (sensor_data_t *)malloc(sizeof(sensor_data_t) * m_last_count);
 	retvm_if(temp == NULL, -ENOMEM, "Memory allocation failed");
-	std::copy(m_sensor_data_cache.begin(), m_sensor_data_cache.end(), temp);
 
-	*len = size;
-	*data = (sensor_data_t *)temp;
+	int count = m_history.get_latest(temp, m_last_count);
+	if (count == 0) {
+		free(temp);
+		return -ENODATA;
+	}
+
+	*len = count * sizeof(sensor_data_t);
+	*data = temp;
 
-	if (m_info.get_uri() != AUTO_ROTATION)
-		m_sensor_data_cache.clear();
+	if (consume)
+		m_read_position = position;
 
 	return 0;
 }
 
-bool sensor_handler::notify_attribute_changed(uint32_t id, int32_t attribute, int32_t value)
+/* peeks at the newest sample, unlike get_cache() it leaves the read position alone */
+int sensor_handler::get_latest(sensor_data_t *data)
 {
-	if (observer_count() == 0)
-		return OP_ERROR;
-
-	cmd_listener_attr_int_t buf;
-	buf.listener_id = id;
-	buf.attribute = attribute;
-	buf.value = value;
+	retv_if(m_history.get_latest(data, 1) == 0, -ENODATA);
 
-	auto msg = ipc::message::create();
+	return 0;
+}
 
-	retvm_if(!msg, OP_ERROR, "Failed to allocate memory");
+int sensor_handler::get_history(unsigned long long start_time, unsigned long long end_time,
+		int max_count, sensor_data_t **data, int *len)
+{
+	int count = std::min<int>(max_count, m_history.get_depth());
+	retv_if(count <= 0, -ENODATA);
 
-	msg->set_type(CMD_LISTENER_SET_ATTR_INT);
-	msg->enclose((char *)&buf, sizeof(buf));
+	sensor_data_t *temp = (sensor_data_t *)malloc(sizeof(sensor_data_t) * count);
+	retvm_if(temp == NULL, -ENOMEM, "Memory allocation failed");
 
-	sensor_listener_proxy *proxy = NULL;
-	for (auto it = m_observers.begin(); it != m_observers.end(); ++it) {
-		proxy = dynamic_cast<sensor_listener_proxy *>(*it);
-		if (proxy && proxy->get_id() != id) {
-			proxy->on_attribute_changed(msg);
-		}
+	count = m_history.get_range(start_time, end_time, temp, count);
+	if (count == 0) {
+		free(temp);
+		return -ENODATA;
 	}
 
-	return OP_SUCCESS;
+	*len = count * sizeof(sensor_data_t);
+	*data = temp;
+
+	return 0;
 }
 
-bool sensor_handler::notify_attribute_changed(uint32_t id, int32_t attribute, const char *value, int len)
+/*
+ * Only subscribed listeners are visited, and no message is built here.
+ * The changes are coalesced per listener and sent once the loop is idle.
+ */
+bool sensor_handler::notify_attribute_changed(uint32_t id, int32_t attribute, int32_t value)
 {
-	if (observer_count() == 0)
+	if (m_attribute_listeners.size() == 0)
 		return OP_ERROR;
 
-	cmd_listener_attr_str_t *buf;
-	size_t size;
-	size = sizeof(cmd_listener_attr_str_t) + len;
-	buf = (cmd_listener_attr_str_t *) new(std::nothrow) char[size];
-	retvm_if(!buf, -ENOMEM, "Failed to allocate memory");
-
-	auto msg = ipc::message::create();
-	if (!msg) {
-		delete[] buf;
-		_E("Failed to allocate memory");
-		return OP_ERROR;
-	}
+	m_attribute_listeners.for_each([id, attribute, value](sensor_listener_proxy *proxy) {
+		if (proxy->get_id() != id)
+			proxy->post_attribute_changed(id, attribute, value);
+	});
 
-	buf->listener_id = id;
-	buf->attribute = attribute;
-	memcpy(buf->value, value, len);
-	buf->len = len;
+	return OP_SUCCESS;
+}
 
-	msg->set_type(CMD_LISTENER_SET_ATTR_STR);
-	msg->enclose((char *)buf, size);
+bool sensor_handler::notify_attribute_changed(uint32_t id, int32_t attribute, const char *value, int len)
+{
+	if (m_attribute_listeners.size() == 0)
+		return OP_ERROR;
 
 	_I("notify attribute changed by listener[%zu]\n", id);
-	sensor_listener_proxy *proxy = NULL;
-	for (auto it = m_observers.begin(); it != m_observers.end(); ++it) {
-		proxy = dynamic_cast<sensor_listener_proxy *>(*it);
-		if (proxy) {
-			proxy->on_attribute_changed(msg);
-		}
-	}
-
-	delete[] buf;
+	m_attribute_listeners.for_each([id, attribute, value, len](sensor_listener_proxy *proxy) {
+		proxy->post_attribute_changed(id, attribute, value, len);
+	});
 
 	return OP_SUCCESS;
 }
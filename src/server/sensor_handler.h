@@ -24,12 +24,15 @@
 #include <sensor_publisher.h>
 #include <sensor_types.h>
 #include <sensor_info.h>
-#include <list>
+#include <sensor_history.h>
+#include <observer_registry.h>
 #include <map>
 #include <vector>
 
 namespace sensor {
 
+class sensor_listener_proxy;
+
 class sensor_handler : public sensor_publisher {
 public:
 	sensor_handler(const sensor_info &info);
@@ -39,9 +42,18 @@ public:
 	bool has_observer(sensor_observer *ob);
 	bool add_observer(sensor_observer *ob);
 	void remove_observer(sensor_observer *ob);
-	int notify(const char *type, sensor_data_t *data, int len);
+	bool add_passive_observer(sensor_observer *ob);
+	void remove_passive_observer(sensor_observer *ob);
+	int notify(sensor_data_t *data, int len);
 	uint32_t observer_count(void);
 
+	/* listeners subscribed to the attribute changes of this sensor */
+	void add_attribute_listener(sensor_listener_proxy *proxy);
+	void remove_attribute_listener(sensor_listener_proxy *proxy);
+
+	int32_t get_id(void);
+	void set_id(int32_t id);
+
 	virtual const sensor_info &get_sensor_info(void) = 0;
 
 	virtual int start(sensor_observer *ob) = 0;
@@ -65,6 +77,9 @@ public:
 
 	void set_cache(sensor_data_t *data, int size);
 	int get_cache(sensor_data_t **data, int *len);
+	int get_latest(sensor_data_t *data);
+	int get_history(unsigned long long start_time, unsigned long long end_time,
+			int max_count, sensor_data_t **data, int *len);
 	bool notify_attribute_changed(uint32_t id, int32_t attribute, int32_t value);
 	bool notify_attribute_changed(uint32_t id, int32_t attribute, const char *value, int len);
 	bool need_to_notify_attribute_changed();
@@ -74,6 +89,7 @@ protected:
 	void update_prev_latency(int32_t latency);
 
 	sensor_info m_info;
+	int32_t m_id;
 	int32_t m_prev_interval;
 	int32_t m_prev_latency;
 
@@ -82,9 +98,17 @@ protected:
 
 	bool m_need_to_notify_attribute_changed;
 private:
-	std::list<sensor_observer *> m_observers;
+	observer_registry<sensor_observer> m_observers;
+
+	/* receive events but are left out of observer_count(), so they never start the sensor */
+	observer_registry<sensor_observer> m_passive_observers;
+
+	observer_registry<sensor_listener_proxy> m_attribute_listeners;
 
-	std::vector<char> m_sensor_data_cache;
+	sensor_history m_history;
+	int m_last_count; /* samples of the last event, 0 if it was not sensor_data_t */
+	uint64_t m_read_position;
+	std::vector<char> m_raw_cache;
 };
 
 }
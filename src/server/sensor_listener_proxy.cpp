@@ -19,28 +19,78 @@
 
 #include "sensor_listener_proxy.h"
 
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
 #include <channel.h>
 #include <message.h>
+#include <timer_wheel.h>
+#include <flight_recorder.h>
 #include <command_types.h>
 #include <sensor_log.h>
 #include <sensor_types.h>
 
 #include "sensor_handler.h"
 #include "sensor_policy_monitor.h"
+#include "event_stats.h"
+#include "delivery_scheduler.h"
+#include "axis_remapper.h"
+#include "attribute_notifier.h"
 
 using namespace sensor;
 
+/* samples arriving up to 1/DECIMATION_TOLERANCE of the interval early still count */
+#define DECIMATION_TOLERANCE 10
+
+/* a batch has to fit in a single message */
+#define MAX_BATCH_EVENTS ((MAX_MSG_CAPACITY - 1) / sizeof(sensor_data_t))
+
+/* why a listener holds its events, see hold() */
+#define HOLD_DISPLAY_OFF 0x1
+#define HOLD_FROZEN 0x2
+
+size_t sensor_listener_proxy::m_hold_limit = LISTENER_HOLD_DEFAULT_LIMIT;
+
 sensor_listener_proxy::sensor_listener_proxy(uint32_t id,
 			std::string uri, sensor_manager *manager, ipc::channel *ch)
 : m_id(id)
 , m_uri(uri)
+, m_sensor_id(-1)
+, m_remappable(false)
+, m_wakeup(false)
 , m_manager(manager)
 , m_ch(ch)
+, m_budget(NULL)
+, m_merger(NULL)
 , m_started(false)
 , m_passive(false)
+, m_hold(0)
+, m_hold_dropped(0)
 , m_pause_policy(SENSORD_PAUSE_ALL)
-, m_axis_orientation(SENSORD_AXIS_DISPLAY_ORIENTED)
+, m_axis_orientation(SENSORD_AXIS_DEVICE_ORIENTED)
 , m_last_accuracy(SENSOR_ACCURACY_UNDEFINED)
+, m_decimation(SENSORD_DECIMATION_SELECT)
+, m_interval(0)
+, m_next_timestamp(0)
+, m_sum_count(0)
+, m_filter_type(SENSORD_FILTER_NONE)
+, m_filter_cutoff(0)
+, m_filter(NULL)
+, m_aggregation(SENSORD_AGGREGATION_NONE)
+, m_window(0)
+, m_window_start(0)
+, m_window_count(0)
+, m_window_axes(0)
+, m_report_mode(SENSORD_REPORT_CONTINUOUS)
+, m_abs_threshold(0)
+, m_rel_threshold(0)
+, m_reported(false)
+, m_batch_latency(0)
+, m_batch_timer(0)
+, m_resume_timer(0)
+, m_attr_changes(SENSORD_ATTRIBUTE_CHANGE_NONE)
+, m_deadline(0)
 , m_need_to_notify_attribute_changed(false)
 {
 	_D("Create [%p][%s]", this, m_uri.data());
@@ -51,7 +101,21 @@ sensor_listener_proxy::~sensor_listener_proxy()
 {
 	_D("Delete [%p][%s]", this, m_uri.data());
 	sensor_policy_monitor::get_instance().remove_listener(this);
+	cancel_batch();
+	cancel_resume();
+	m_batch.reset();
+	delivery_scheduler::get_instance().cancel(m_ch);
+	sensor_filter::release(m_filter);
+	if (m_merger)
+		m_merger->remove_member(m_id);
+	attribute_notifier::get_instance().cancel(this);
+	if (m_attr_changes != SENSORD_ATTRIBUTE_CHANGE_NONE) {
+		sensor_handler *sensor = get_sensor();
+		if (sensor)
+			sensor->remove_attribute_listener(this);
+	}
 	stop();
+	client_budget::release(m_budget);
 }
 
 uint32_t sensor_listener_proxy::get_id(void)
@@ -59,16 +123,430 @@ uint32_t sensor_listener_proxy::get_id(void)
 	return m_id;
 }
 
-int sensor_listener_proxy::update(const char *uri, std::shared_ptr<ipc::message> msg)
+void sensor_listener_proxy::set_client(const std::string &client)
+{
+	client_budget::release(m_budget);
+	m_budget = client_budget::acquire(client);
+}
+
+ipc::channel *sensor_listener_proxy::get_channel(void)
+{
+	return m_ch;
+}
+
+int32_t sensor_listener_proxy::get_sensor_id(void)
+{
+	if (m_sensor_id < 0)
+		get_sensor();
+
+	return m_sensor_id;
+}
+
+void sensor_listener_proxy::set_merger(event_merger *merger)
+{
+	m_merger = merger;
+}
+
+event_merger *sensor_listener_proxy::get_merger(void)
+{
+	return m_merger;
+}
+
+/* the uri is resolved once, later lookups index the manager's table by id */
+sensor_handler *sensor_listener_proxy::get_sensor(void)
+{
+	if (m_sensor_id < 0) {
+		sensor_handler *sensor = m_manager->get_sensor(m_uri);
+		retv_if(!sensor, NULL);
+
+		sensor_info info = sensor->get_sensor_info();
+		m_remappable = axis_remapper::is_remappable(info.get_type());
+		m_wakeup = info.is_wakeup_supported();
+		m_sensor_id = sensor->get_id();
+		return sensor;
+	}
+
+	return m_manager->get_sensor(m_sensor_id);
+}
+
+int sensor_listener_proxy::update(int32_t id, std::shared_ptr<ipc::message> msg)
 {
 	retv_if(!m_ch || !m_ch->is_connected(), OP_CONTINUE);
 
-	update_event(msg);
-	update_accuracy(msg);
+	if (m_filter)
+		msg = m_filter->apply(msg);
+
+	/* only listeners that asked for display oriented axes get them,
+	 * they share one remapped copy of the event */
+	if (m_remappable && m_axis_orientation == SENSORD_AXIS_DISPLAY_ORIENTED)
+		msg = axis_remapper::get_instance().remap(msg);
+
+	/* a client which stopped reading is frozen until its queue drains, see drained() */
+	if (is_frozen())
+		hold(HOLD_FROZEN);
+
+	/* what arrives meanwhile goes out in order on resume() */
+	if (m_hold && keep(msg))
+		return OP_CONTINUE;
+
+	deliver(msg);
 
 	return OP_CONTINUE;
 }
 
+/* the listener's own stages, the message may still be shared with others */
+void sensor_listener_proxy::deliver(std::shared_ptr<ipc::message> msg)
+{
+	size_t size = msg->size();
+	bool aggregated = m_aggregation != SENSORD_AGGREGATION_NONE && m_window > 0;
+	bool budgeted = m_budget && m_budget->is_limited();
+	bool filtered = (m_decimation != SENSORD_DECIMATION_NONE && m_interval > 0) ||
+			m_batch_latency > 0 || is_change_filtered() || aggregated || budgeted;
+
+	/* other payloads and unfiltered listeners share the message as it is */
+	if (!filtered || size == 0 || size % sizeof(sensor_data_t)) {
+		if (m_budget && size % sizeof(sensor_data_t) == 0)
+			m_budget->consume(size / sizeof(sensor_data_t));
+		update_event(msg);
+		update_accuracy(msg);
+		return;
+	}
+
+	/* a message may carry all samples a sensor produced in one wakeup */
+	const sensor_data_t *data = reinterpret_cast<sensor_data_t *>(msg->body());
+	int count = size / sizeof(sensor_data_t);
+	int unchanged = 0;
+	std::shared_ptr<ipc::message> selected_msg;
+
+	for (int i = 0; i < count; ++i) {
+		/* a window summary takes the place of the decimated sample */
+		const sensor_data_t *sample = aggregated ? aggregate(&data[i]) : decimate(&data[i]);
+		if (sample && !has_changed(sample))
+			sample = NULL;
+
+		/* a client over its budget is decimated down to its share */
+		if (sample && m_budget && !m_budget->consume(1))
+			sample = NULL;
+
+		bool pass = sample && !batch(sample);
+
+		/* the shared message is forwarded as long as every sample passes as it is */
+		if (!selected_msg) {
+			if (pass && sample == &data[i]) {
+				unchanged++;
+				continue;
+			}
+
+			selected_msg = create_event(size);
+			if (!selected_msg)
+				break;
+
+			selected_msg->append(data, unchanged * sizeof(sensor_data_t));
+			event_stats::copied(unchanged, unchanged * sizeof(sensor_data_t));
+		}
+
+		if (pass) {
+			selected_msg->append(sample, sizeof(sensor_data_t));
+			event_stats::copied(1, sizeof(sensor_data_t));
+		}
+	}
+
+	if (unchanged == count)
+		update_event(msg);
+	else if (selected_msg && selected_msg->size())
+		update_event(selected_msg);
+
+	update_accuracy(msg);
+}
+
+/*
+ * The sensor runs at the fastest interval requested by any listener, so
+ * slower listeners would otherwise receive every sample. A sample is
+ * forwarded once its timestamp reaches the next point on this listener's
+ * interval grid. In average mode the forwarded sample carries the mean of
+ * all samples since the previous one.
+ */
+const sensor_data_t *sensor_listener_proxy::decimate(const sensor_data_t *data)
+{
+	retv_if(m_decimation == SENSORD_DECIMATION_NONE, data);
+	retv_if(m_interval <= 0, data);
+
+	unsigned long long interval = (unsigned long long)m_interval * 1000;
+	unsigned long long tolerance = interval / DECIMATION_TOLERANCE;
+
+	/* timestamp went backwards, e.g. the sensor was restarted */
+	if (m_next_timestamp > data->timestamp + interval)
+		reset_decimation();
+
+	if (m_decimation == SENSORD_DECIMATION_AVERAGE) {
+		int count = data->value_count;
+		if (count < 0 || count > SENSOR_DATA_VALUE_SIZE)
+			count = SENSOR_DATA_VALUE_SIZE;
+
+		if (m_sum_count == 0 || m_sum.value_count != data->value_count)
+			memset(&m_sum, 0, sizeof(m_sum));
+		for (int i = 0; i < count; ++i)
+			m_sum.values[i] += data->values[i];
+		m_sum.value_count = data->value_count;
+		m_sum_count++;
+	}
+
+	if (m_next_timestamp && data->timestamp + tolerance < m_next_timestamp)
+		return NULL;
+
+	/* stay on the grid to avoid drift, but resync after a gap */
+	m_next_timestamp = m_next_timestamp ? m_next_timestamp + interval : data->timestamp + interval;
+	if (m_next_timestamp <= data->timestamp)
+		m_next_timestamp = data->timestamp + interval;
+
+	if (m_decimation != SENSORD_DECIMATION_AVERAGE || m_sum_count <= 1) {
+		m_sum_count = 0;
+		return data;
+	}
+
+	int count = data->value_count;
+	if (count < 0 || count > SENSOR_DATA_VALUE_SIZE)
+		count = SENSOR_DATA_VALUE_SIZE;
+
+	memcpy(&m_avg, data, sizeof(sensor_data_t));
+	for (int i = 0; i < count; ++i)
+		m_avg.values[i] = m_sum.values[i] / m_sum_count;
+	m_sum_count = 0;
+
+	return &m_avg;
+}
+
+void sensor_listener_proxy::reset_decimation(void)
+{
+	m_next_timestamp = 0;
+	m_sum_count = 0;
+}
+
+/*
+ * Keeps running sums over the current window and emits one summary event
+ * when a sample reaches the end of it, carrying the selected statistics
+ * laid out as described by sensord_aggregation_e.
+ */
+const sensor_data_t *sensor_listener_proxy::aggregate(const sensor_data_t *data)
+{
+	unsigned long long window = (unsigned long long)m_window * 1000;
+
+	int axes = data->value_count;
+	if (axes < 0 || axes > SENSOR_DATA_VALUE_SIZE)
+		axes = SENSOR_DATA_VALUE_SIZE;
+
+	/* timestamp went backwards or the layout changed, start over */
+	if (m_window_count > 0 && (data->timestamp < m_window_start || axes != m_window_axes))
+		reset_aggregation();
+
+	if (m_window_count == 0) {
+		m_window_start = data->timestamp;
+		m_window_axes = axes;
+		for (int i = 0; i < axes; ++i) {
+			m_window_sum[i] = 0;
+			m_window_sq_sum[i] = 0;
+			m_window_min[i] = data->values[i];
+			m_window_max[i] = data->values[i];
+		}
+	}
+
+	for (int i = 0; i < axes; ++i) {
+		float value = data->values[i];
+
+		m_window_sum[i] += value;
+		m_window_sq_sum[i] += (double)value * value;
+		if (value < m_window_min[i])
+			m_window_min[i] = value;
+		if (value > m_window_max[i])
+			m_window_max[i] = value;
+	}
+	m_window_count++;
+
+	retv_if(data->timestamp < m_window_start + window, NULL);
+
+	memset(&m_summary, 0, sizeof(m_summary));
+	m_summary.accuracy = data->accuracy;
+	m_summary.timestamp = data->timestamp;
+
+	int count = 0;
+	for (int stat = SENSORD_AGGREGATION_MEAN; stat <= SENSORD_AGGREGATION_RMS; stat <<= 1) {
+		if (!(m_aggregation & stat))
+			continue;
+
+		for (int i = 0; i < axes && count < SENSOR_DATA_VALUE_SIZE; ++i) {
+			float value;
+
+			if (stat == SENSORD_AGGREGATION_MEAN)
+				value = m_window_sum[i] / m_window_count;
+			else if (stat == SENSORD_AGGREGATION_MIN)
+				value = m_window_min[i];
+			else if (stat == SENSORD_AGGREGATION_MAX)
+				value = m_window_max[i];
+			else
+				value = sqrt(m_window_sq_sum[i] / m_window_count);
+
+			m_summary.values[count++] = value;
+		}
+	}
+	m_summary.value_count = count;
+
+	reset_aggregation();
+
+	return &m_summary;
+}
+
+void sensor_listener_proxy::reset_aggregation(void)
+{
+	m_window_start = 0;
+	m_window_count = 0;
+}
+
+int sensor_listener_proxy::update_filter(int32_t type, int32_t cutoff)
+{
+	retv_if(type < SENSORD_FILTER_NONE || type > SENSORD_FILTER_BIQUAD_HIGH_PASS, -EINVAL);
+	retv_if(cutoff < 0, -EINVAL);
+
+	sensor_handler *sensor = get_sensor();
+	retv_if(!sensor, -EINVAL);
+
+	/* joins the group of the new parameters, or none until both are set */
+	sensor_filter *filter = sensor_filter::acquire(sensor->get_id(), type, cutoff);
+	sensor_filter::release(m_filter);
+
+	m_filter = filter;
+	m_filter_type = type;
+	m_filter_cutoff = cutoff;
+
+	return OP_SUCCESS;
+}
+
+bool sensor_listener_proxy::is_change_filtered(void)
+{
+	return m_report_mode == SENSORD_REPORT_ON_CHANGE || m_abs_threshold > 0 || m_rel_threshold > 0;
+}
+
+/*
+ * A sample is forwarded only if a value moved away from the last forwarded
+ * one by more than both thresholds, so slow drifts add up until they are
+ * reported. Without thresholds, on-change mode forwards any difference.
+ */
+bool sensor_listener_proxy::has_changed(const sensor_data_t *data)
+{
+	retv_if(!is_change_filtered(), true);
+
+	bool changed = !m_reported ||
+			data->value_count != m_last_reported.value_count ||
+			data->accuracy != m_last_reported.accuracy;
+
+	int count = data->value_count;
+	if (count < 0 || count > SENSOR_DATA_VALUE_SIZE)
+		count = SENSOR_DATA_VALUE_SIZE;
+
+	for (int i = 0; i < count && !changed; ++i) {
+		float last = m_last_reported.values[i];
+		float delta = fabsf(data->values[i] - last);
+
+		if (delta == 0)
+			continue;
+		if (delta * 1000 < m_abs_threshold)
+			continue;
+		if (delta * 1000 < m_rel_threshold * fabsf(last))
+			continue;
+
+		changed = true;
+	}
+
+	retv_if(!changed, false);
+
+	memcpy(&m_last_reported, data, sizeof(sensor_data_t));
+	m_reported = true;
+
+	return true;
+}
+
+/* the next sample is reported as is, only the filter settings may start it over */
+void sensor_listener_proxy::reset_change_filter(void)
+{
+	m_reported = false;
+}
+
+/*
+ * Software sensors ignore the batch latency and hardware batches arrive one
+ * sample at a time, so samples are held here and sent as one message when
+ * the listener's latency expires or the buffer is full.
+ */
+bool sensor_listener_proxy::batch(const sensor_data_t *data)
+{
+	retv_if(m_batch_latency <= 0, false);
+
+	if (!m_batch) {
+		ipc::event_loop *loop = m_ch->loop();
+		ipc::timer_wheel *wheel = loop ? loop->get_timer_wheel() : NULL;
+		retv_if(!wheel, false);
+
+		/* samples are copied once, straight into the message that is sent */
+		m_batch = create_event(MAX_BATCH_EVENTS * sizeof(sensor_data_t));
+		retv_if(!m_batch, false);
+
+		m_batch_timer = wheel->add_timer(m_batch_latency, false, batch_timeout, this);
+		if (!m_batch_timer) {
+			_E("Failed to add batch timer");
+			m_batch.reset();
+			return false;
+		}
+	}
+
+	m_batch->append(data, sizeof(sensor_data_t));
+	event_stats::copied(1, sizeof(sensor_data_t));
+
+	if (m_batch->size() >= MAX_BATCH_EVENTS * sizeof(sensor_data_t))
+		flush_batch();
+
+	return true;
+}
+
+void sensor_listener_proxy::flush_batch(void)
+{
+	cancel_batch();
+	ret_if(!m_batch);
+
+	if (m_ch && m_ch->is_connected() && m_batch->size())
+		update_event(m_batch);
+
+	m_batch.reset();
+}
+
+std::shared_ptr<ipc::message> sensor_listener_proxy::create_event(size_t capacity)
+{
+	auto msg = ipc::message::create(capacity);
+	retvm_if(!msg, msg, "Failed to allocate memory");
+
+	msg->header()->type = CMD_LISTENER_EVENT;
+	msg->header()->err = OP_SUCCESS;
+
+	return msg;
+}
+
+void sensor_listener_proxy::cancel_batch(void)
+{
+	ret_if(!m_batch_timer);
+
+	ipc::event_loop *loop = m_ch ? m_ch->loop() : NULL;
+	ipc::timer_wheel *wheel = loop ? loop->get_timer_wheel() : NULL;
+	if (wheel)
+		wheel->remove_timer(m_batch_timer);
+
+	m_batch_timer = 0;
+}
+
+void sensor_listener_proxy::batch_timeout(uint64_t id, void *data)
+{
+	sensor_listener_proxy *proxy = reinterpret_cast<sensor_listener_proxy *>(data);
+
+	proxy->m_batch_timer = 0;
+	proxy->flush_batch();
+}
+
 int sensor_listener_proxy::on_attribute_changed(std::shared_ptr<ipc::message> msg)
 {
 	retv_if(!m_ch || !m_ch->is_connected(), OP_CONTINUE);
@@ -77,19 +555,66 @@ int sensor_listener_proxy::on_attribute_changed(std::shared_ptr<ipc::message> ms
 	return OP_CONTINUE;
 }
 
+void sensor_listener_proxy::post_attribute_changed(uint32_t id, int32_t attribute, int32_t value)
+{
+	ret_if(!(m_attr_changes & SENSORD_ATTRIBUTE_CHANGE_INT));
+	ret_if(!m_ch || !m_ch->is_connected());
+
+	attribute_notifier::get_instance().post(m_ch->loop(), this, id, attribute, value);
+}
+
+void sensor_listener_proxy::post_attribute_changed(uint32_t id, int32_t attribute, const char *value, int len)
+{
+	ret_if(!(m_attr_changes & SENSORD_ATTRIBUTE_CHANGE_STR));
+	ret_if(!m_ch || !m_ch->is_connected());
+
+	attribute_notifier::get_instance().post(m_ch->loop(), this, id, attribute, value, len);
+}
+
 void sensor_listener_proxy::update_event(std::shared_ptr<ipc::message> msg)
 {
-	/* TODO: check axis orientation */
-	msg->header()->type = CMD_LISTENER_EVENT;
-	msg->header()->err = OP_SUCCESS;
+	size_t size = msg->size();
+	if (size && size % sizeof(sensor_data_t) == 0) {
+		int count = size / sizeof(sensor_data_t);
+		const sensor_data_t *data = reinterpret_cast<sensor_data_t *>(msg->body());
+		flight_recorder::record(FLIGHT_RECORD_DELIVERY, m_id, data[count - 1].timestamp, count);
+	}
 
-	m_ch->send(msg);
+	if (m_merger) {
+		m_merger->push(m_id, msg);
+		return;
+	}
+
+	/* the message may be shared with other listeners, so it is sent as it is */
+	delivery_scheduler::get_instance().submit(m_ch, get_deadline(msg), msg);
+}
+
+unsigned long long sensor_listener_proxy::get_deadline(std::shared_ptr<ipc::message> msg)
+{
+	retv_if(m_deadline <= 0, delivery_scheduler::NO_DEADLINE);
+
+	unsigned long long timestamp;
+
+	/* the oldest sample in the message sets the deadline */
+	if (msg->size() >= sizeof(sensor_data_t) && msg->size() % sizeof(sensor_data_t) == 0) {
+		timestamp = reinterpret_cast<sensor_data_t *>(msg->body())->timestamp;
+	} else {
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		timestamp = ((unsigned long long)(ts.tv_sec)*1000000000LL + ts.tv_nsec) / 1000;
+	}
+
+	return timestamp + (unsigned long long)m_deadline * 1000;
 }
 
 void sensor_listener_proxy::update_accuracy(std::shared_ptr<ipc::message> msg)
 {
 	sensor_data_t *data = reinterpret_cast<sensor_data_t *>(msg->body());
 
+	/* the newest sample decides */
+	if (msg->size() > sizeof(sensor_data_t) && msg->size() % sizeof(sensor_data_t) == 0)
+		data += msg->size() / sizeof(sensor_data_t) - 1;
+
 	if (data->accuracy == m_last_accuracy)
 		return;
 
@@ -110,20 +635,27 @@ void sensor_listener_proxy::update_accuracy(std::shared_ptr<ipc::message> msg)
 	acc_msg->header()->err = OP_SUCCESS;
 	acc_msg->enclose(&acc_data, sizeof(acc_data));
 
-	m_ch->send(acc_msg);
+	/* after the event it belongs to */
+	delivery_scheduler::get_instance().submit(m_ch, get_deadline(acc_msg), acc_msg);
 }
 
 int sensor_listener_proxy::start(bool policy)
 {
 	int ret;
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 	retvm_if(m_started && !policy, OP_SUCCESS, "Sensor is already started");
 
 	_D("Listener[%d] try to start", get_id());
 
-	ret = sensor->start(this);
-	retv_if(ret < 0, OP_ERROR);
+	if (m_passive) {
+		/* rides along on the active listeners, never enables the sensor */
+		sensor->add_passive_observer(this);
+		ret = OP_SUCCESS;
+	} else {
+		ret = sensor->start(this);
+		retv_if(ret < 0, OP_ERROR);
+	}
 
 	/* m_started is changed only when it is explicitly called by user,
 	 * not automatically determined by any pause policy. */
@@ -136,22 +668,35 @@ int sensor_listener_proxy::start(bool policy)
 
 int sensor_listener_proxy::stop(bool policy)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 	retvm_if(!m_started && !policy, OP_SUCCESS, "Sensor is already stopped");
 
 	_D("Listener[%d] try to stop", get_id());
 
-	int ret = sensor->stop(this);
+	int ret = OP_SUCCESS;
+	if (m_passive)
+		sensor->remove_passive_observer(this);
+	else
+		ret = sensor->stop(this);
 	retv_if(ret < 0, OP_ERROR);
 
 	/* attributes and m_started are changed only when it is explicitly called by user,
 	 * not automatically determined by any policy. */
-	if (policy)
+	if (policy) {
+		flush_batch();
 		return OP_SUCCESS;
+	}
+
+	m_hold = 0;
+	m_held.clear();
+	cancel_resume();
 
 	/* unset attributes */
 	delete_batch_latency();
+	reset_decimation();
+	reset_aggregation();
+	reset_change_filter();
 
 	m_started = false;
 	return OP_SUCCESS;
@@ -159,11 +704,17 @@ int sensor_listener_proxy::stop(bool policy)
 
 int sensor_listener_proxy::set_interval(int32_t interval)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
 	_D("Listener[%d] try to set interval[%d]", get_id(), interval);
 
+	m_interval = interval;
+	reset_decimation();
+
+	/* passive listeners only decimate, they take no part in the arbitration */
+	retv_if(m_passive, OP_SUCCESS);
+
 	int ret = sensor->set_interval(this, interval);
 	apply_sensor_handler_need_to_notify_attribute_changed(sensor);
 
@@ -172,7 +723,7 @@ int sensor_listener_proxy::set_interval(int32_t interval)
 
 int sensor_listener_proxy::get_interval(int32_t& interval)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
 	_D("Listener[%d] try to get interval", get_id());
@@ -182,10 +733,16 @@ int sensor_listener_proxy::get_interval(int32_t& interval)
 
 int sensor_listener_proxy::set_max_batch_latency(int32_t max_batch_latency)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
 	_D("Listener[%d] try to set max batch latency[%d]", get_id(), max_batch_latency);
+
+	flush_batch();
+	m_batch_latency = max_batch_latency;
+
+	retv_if(m_passive, OP_SUCCESS);
+
 	int ret = sensor->set_batch_latency(this, max_batch_latency);
 	apply_sensor_handler_need_to_notify_attribute_changed(sensor);
 
@@ -194,7 +751,7 @@ int sensor_listener_proxy::set_max_batch_latency(int32_t max_batch_latency)
 
 int sensor_listener_proxy::get_max_batch_latency(int32_t& max_batch_latency)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
 	_D("Listener[%d] try to get max batch latency", get_id());
@@ -204,24 +761,57 @@ int sensor_listener_proxy::get_max_batch_latency(int32_t& max_batch_latency)
 
 int sensor_listener_proxy::delete_batch_latency(void)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
 	_I("Listener[%d] try to delete batch latency", get_id());
 
+	flush_batch();
+	m_batch_latency = 0;
+
 	return sensor->delete_batch_latency(this);
 }
 
 int sensor_listener_proxy::set_passive_mode(bool passive)
 {
-	/* TODO: passive mode */
+	sensor_handler *sensor = get_sensor();
+	retv_if(!sensor, -EINVAL);
+	retv_if(m_passive == passive, OP_SUCCESS);
+
+	_I("Listener[%d] set passive mode[%d]", get_id(), passive);
+
+	if (!m_started) {
+		m_passive = passive;
+		return OP_SUCCESS;
+	}
+
+	/* move between the active and passive observers of the running sensor */
+	stop(true);
 	m_passive = passive;
+	int ret = start(true);
+	retv_if(ret < 0, ret);
+
+	if (passive) {
+		sensor->delete_batch_latency(this);
+		return OP_SUCCESS;
+	}
+
+	if (m_interval > 0)
+		sensor->set_interval(this, m_interval);
+	if (m_batch_latency > 0)
+		sensor->set_batch_latency(this, m_batch_latency);
+
 	return OP_SUCCESS;
 }
 
+bool sensor_listener_proxy::get_passive_mode(void)
+{
+	return m_passive;
+}
+
 int sensor_listener_proxy::set_attribute(int32_t attribute, int32_t value)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
 	_D("Listener[%d] try to set attribute[%d, %d]", get_id(), attribute, value);
@@ -240,6 +830,72 @@ int sensor_listener_proxy::set_attribute(int32_t attribute, int32_t value)
 		return OP_SUCCESS;
 	} else if (attribute == SENSORD_ATTRIBUTE_FLUSH) {
 		return flush();
+	} else if (attribute == SENSORD_ATTRIBUTE_DECIMATION) {
+		retv_if(value < SENSORD_DECIMATION_NONE || value > SENSORD_DECIMATION_AVERAGE, -EINVAL);
+		if (m_decimation != value) {
+			m_decimation = value;
+			reset_decimation();
+		}
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_QUEUE_POLICY) {
+		retv_if(value < SENSORD_QUEUE_DROP_OLDEST || value > SENSORD_QUEUE_LATEST_ONLY, -EINVAL);
+		retv_if(!m_ch, -EIO);
+		m_ch->set_send_policy(value);
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_QUEUE_SIZE) {
+		retv_if(value <= 0, -EINVAL);
+		retv_if(!m_ch, -EIO);
+		m_ch->set_send_limit(value);
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_DROPPED_EVENTS) {
+		return -EINVAL;
+	} else if (attribute == SENSORD_ATTRIBUTE_DELIVERY_DEADLINE) {
+		retv_if(value < 0, -EINVAL);
+		m_deadline = value;
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_FILTER) {
+		return update_filter(value, m_filter_cutoff);
+	} else if (attribute == SENSORD_ATTRIBUTE_FILTER_CUTOFF) {
+		return update_filter(m_filter_type, value);
+	} else if (attribute == SENSORD_ATTRIBUTE_AGGREGATION) {
+		retv_if(value & ~SENSORD_AGGREGATION_ALL, -EINVAL);
+		m_aggregation = value;
+		reset_aggregation();
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_AGGREGATION_WINDOW) {
+		retv_if(value < 0, -EINVAL);
+		m_window = value;
+		reset_aggregation();
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_REPORT_MODE) {
+		retv_if(value < SENSORD_REPORT_CONTINUOUS || value > SENSORD_REPORT_ON_CHANGE, -EINVAL);
+		if (m_report_mode != value) {
+			m_report_mode = value;
+			reset_change_filter();
+		}
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_ABS_THRESHOLD) {
+		retv_if(value < 0, -EINVAL);
+		if (m_abs_threshold != value) {
+			m_abs_threshold = value;
+			reset_change_filter();
+		}
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_REL_THRESHOLD) {
+		retv_if(value < 0, -EINVAL);
+		if (m_rel_threshold != value) {
+			m_rel_threshold = value;
+			reset_change_filter();
+		}
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_CHANGE_SUBSCRIPTION) {
+		retv_if(value & ~(SENSORD_ATTRIBUTE_CHANGE_INT | SENSORD_ATTRIBUTE_CHANGE_STR), -EINVAL);
+		m_attr_changes = value;
+		if (m_attr_changes != SENSORD_ATTRIBUTE_CHANGE_NONE)
+			sensor->add_attribute_listener(this);
+		else
+			sensor->remove_attribute_listener(this);
+		return OP_SUCCESS;
 	}
 
 	int ret = sensor->set_attribute(this, attribute, value);
@@ -250,7 +906,7 @@ int sensor_listener_proxy::set_attribute(int32_t attribute, int32_t value)
 
 int sensor_listener_proxy::get_attribute(int32_t attribute, int32_t *value)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
 	_D("Listener[%d] try to get attribute[%d] int", get_id(), attribute);
@@ -263,6 +919,49 @@ int sensor_listener_proxy::get_attribute(int32_t attribute, int32_t *value)
 		return OP_SUCCESS;
 	} else if (attribute == SENSORD_ATTRIBUTE_FLUSH) {
 		return -EINVAL;
+	} else if (attribute == SENSORD_ATTRIBUTE_DECIMATION) {
+		*value = m_decimation;
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_QUEUE_POLICY) {
+		retv_if(!m_ch, -EIO);
+		*value = m_ch->get_send_policy();
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_QUEUE_SIZE) {
+		retv_if(!m_ch, -EIO);
+		*value = m_ch->get_send_limit();
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_DROPPED_EVENTS) {
+		retv_if(!m_ch, -EIO);
+		uint64_t dropped = m_ch->get_dropped_count() + m_hold_dropped;
+		*value = dropped > INT32_MAX ? INT32_MAX : (int32_t)dropped;
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_DELIVERY_DEADLINE) {
+		*value = m_deadline;
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_FILTER) {
+		*value = m_filter_type;
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_FILTER_CUTOFF) {
+		*value = m_filter_cutoff;
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_AGGREGATION) {
+		*value = m_aggregation;
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_AGGREGATION_WINDOW) {
+		*value = m_window;
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_REPORT_MODE) {
+		*value = m_report_mode;
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_ABS_THRESHOLD) {
+		*value = m_abs_threshold;
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_REL_THRESHOLD) {
+		*value = m_rel_threshold;
+		return OP_SUCCESS;
+	} else if (attribute == SENSORD_ATTRIBUTE_CHANGE_SUBSCRIPTION) {
+		*value = m_attr_changes;
+		return OP_SUCCESS;
 	}
 
 	return sensor->get_attribute(attribute, value);
@@ -270,7 +969,7 @@ int sensor_listener_proxy::get_attribute(int32_t attribute, int32_t *value)
 
 int sensor_listener_proxy::set_attribute(int32_t attribute, const char *value, int len)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
 	_D("Listener[%d] try to set string attribute[%d], len[%d]", get_id(), attribute, len);
@@ -283,7 +982,7 @@ int sensor_listener_proxy::set_attribute(int32_t attribute, const char *value, i
 
 int sensor_listener_proxy::get_attribute(int32_t attribute, char **value, int *len)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
 	_D("Listener[%d] try to get attribute str[%d]", get_id(), attribute);
@@ -293,23 +992,42 @@ int sensor_listener_proxy::get_attribute(int32_t attribute, char **value, int *l
 
 int sensor_listener_proxy::flush(void)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
+	flush_batch();
+
 	return sensor->flush(this);
 }
 
 int sensor_listener_proxy::get_data(sensor_data_t **data, int *len)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
 	return sensor->get_cache(data, len);
 }
 
+int sensor_listener_proxy::get_latest_data(sensor_data_t *data)
+{
+	sensor_handler *sensor = get_sensor();
+	retv_if(!sensor, -EINVAL);
+
+	return sensor->get_latest(data);
+}
+
+int sensor_listener_proxy::get_data_history(unsigned long long start_time, unsigned long long end_time,
+		int max_count, sensor_data_t **data, int *len)
+{
+	sensor_handler *sensor = get_sensor();
+	retv_if(!sensor, -EINVAL);
+
+	return sensor->get_history(start_time, end_time, max_count, data, len);
+}
+
 std::string sensor_listener_proxy::get_required_privileges(void)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, "");
 
 	sensor_info info = sensor->get_sensor_info();
@@ -320,6 +1038,13 @@ void sensor_listener_proxy::on_policy_changed(int policy, int value)
 {
 	ret_if(m_started == false);
 	ret_if(policy != SENSORD_ATTRIBUTE_PAUSE_POLICY);
+
+	/* listeners that keep running with the display off get their events on resume */
+	if ((value & SENSORD_PAUSE_ON_DISPLAY_OFF) && !(value & m_pause_policy) && !m_wakeup)
+		hold(HOLD_DISPLAY_OFF);
+	else
+		release(HOLD_DISPLAY_OFF);
+
 	ret_if(m_pause_policy == SENSORD_PAUSE_NONE);
 
 	_D("power_save_state[%d], listener[%d] pause policy[%d]",
@@ -331,9 +1056,152 @@ void sensor_listener_proxy::on_policy_changed(int policy, int value)
 		start(true);
 }
 
+void sensor_listener_proxy::set_hold_limit(size_t limit)
+{
+	m_hold_limit = limit ? limit : 1;
+}
+
+/*
+ * A non-wakeup client whose outbound queue is full is not reading its
+ * socket. Holding its events costs less than dropping them in the queue.
+ * LATEST_ONLY clients asked for the newest event only, so they are left alone.
+ * [pending] counts messages sent but maybe not queued yet.
+ */
+bool sensor_listener_proxy::is_frozen(size_t pending)
+{
+	retv_if(m_wakeup, false);
+	retv_if(m_ch->get_send_policy() == ipc::SEND_POLICY_LATEST_ONLY, false);
+
+	return m_ch->get_send_queue_size() + pending >= m_ch->get_send_limit();
+}
+
+void sensor_listener_proxy::hold(int reason)
+{
+	ret_if(m_hold & reason);
+
+	/* the pending batch goes out before the client is left alone */
+	if (!m_hold)
+		flush_batch();
+
+	m_hold |= reason;
+
+	_D("Listener[%d] holds events[0x%x]", get_id(), m_hold);
+
+	/*
+	 * The drain of the queue releases a frozen listener. If only deferred
+	 * deliveries made it look frozen, they may be written out without ever
+	 * being queued, so the listener also checks for itself after a while.
+	 */
+	ret_if(reason != HOLD_FROZEN || m_resume_timer);
+
+	ipc::event_loop *loop = m_ch->loop();
+	ipc::timer_wheel *wheel = loop ? loop->get_timer_wheel() : NULL;
+	ret_if(!wheel);
+
+	m_resume_timer = wheel->add_timer(LISTENER_RESUME_RETRY_MS, false, resume_timeout, this);
+	warn_if(!m_resume_timer, "Failed to add resume timer");
+}
+
+void sensor_listener_proxy::release(int reason)
+{
+	ret_if(!(m_hold & reason));
+
+	m_hold &= ~reason;
+	ret_if(m_hold);
+
+	resume();
+}
+
+/* only samples can be held, the caller delivers anything else right away */
+bool sensor_listener_proxy::keep(std::shared_ptr<ipc::message> msg)
+{
+	size_t size = msg->size();
+	retv_if(size == 0 || size % sizeof(sensor_data_t), false);
+
+	const sensor_data_t *data = reinterpret_cast<sensor_data_t *>(msg->body());
+
+	for (size_t i = 0; i < size / sizeof(sensor_data_t); ++i) {
+		if (m_held.size() >= m_hold_limit) {
+			m_held.pop_front();
+			m_hold_dropped++;
+		}
+		m_held.push_back(data[i]);
+	}
+
+	return true;
+}
+
+void sensor_listener_proxy::drained(void)
+{
+	release(HOLD_FROZEN);
+}
+
+void sensor_listener_proxy::cancel_resume(void)
+{
+	ret_if(!m_resume_timer);
+
+	ipc::event_loop *loop = m_ch ? m_ch->loop() : NULL;
+	ipc::timer_wheel *wheel = loop ? loop->get_timer_wheel() : NULL;
+	if (wheel)
+		wheel->remove_timer(m_resume_timer);
+
+	m_resume_timer = 0;
+}
+
+void sensor_listener_proxy::resume_timeout(uint64_t id, void *data)
+{
+	sensor_listener_proxy *proxy = reinterpret_cast<sensor_listener_proxy *>(data);
+
+	proxy->m_resume_timer = 0;
+
+	/* a queue with messages in it is released by its drain */
+	if (proxy->m_ch->get_send_queue_size() == 0)
+		proxy->release(HOLD_FROZEN);
+}
+
+/*
+ * Hands the held samples to the client through the listener's own stages,
+ * a message at a time. Deliveries may be deferred until the current wakeup
+ * ends, so the messages are counted against the queue up front. What does
+ * not fit stays held until the queue drains.
+ */
+void sensor_listener_proxy::resume(void)
+{
+	warn_if(m_hold_dropped > 0, "Listener[%d] dropped %llu held events so far",
+			get_id(), (unsigned long long)m_hold_dropped);
+
+	_D("Listener[%d] resumes with %zu held events", get_id(), m_held.size());
+
+	size_t sent = 0;
+
+	while (!m_held.empty()) {
+		if (is_frozen(sent)) {
+			hold(HOLD_FROZEN);
+			return;
+		}
+
+		size_t count = std::min(m_held.size(), (size_t)MAX_BATCH_EVENTS);
+
+		auto msg = create_event(count * sizeof(sensor_data_t));
+		if (!msg) {
+			m_hold_dropped += m_held.size();
+			m_held.clear();
+			return;
+		}
+
+		for (size_t i = 0; i < count; ++i) {
+			msg->append(&m_held.front(), sizeof(sensor_data_t));
+			m_held.pop_front();
+		}
+
+		deliver(msg);
+		sent++;
+	}
+}
+
 bool sensor_listener_proxy::notify_attribute_changed(int32_t attribute, int32_t value)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
 	return sensor->notify_attribute_changed(m_id, attribute, value);
@@ -341,7 +1209,7 @@ bool sensor_listener_proxy::notify_attribute_changed(int32_t attribute, int32_t
 
 bool sensor_listener_proxy::notify_attribute_changed(int attribute, const char *value, int len)
 {
-	sensor_handler *sensor = m_manager->get_sensor(m_uri);
+	sensor_handler *sensor = get_sensor();
 	retv_if(!sensor, -EINVAL);
 
 	return sensor->notify_attribute_changed(m_id, attribute, value, len);
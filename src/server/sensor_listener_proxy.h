@@ -20,12 +20,21 @@
 #ifndef __SENSOR_LISTENER_PROXY_H__
 #define __SENSOR_LISTENER_PROXY_H__
 
+#include <deque>
 #include <channel.h>
 #include <message.h>
 
 #include "sensor_manager.h"
 #include "sensor_observer.h"
 #include "sensor_policy_listener.h"
+#include "sensor_filter.h"
+#include "client_budget.h"
+#include "event_merger.h"
+
+/* samples a listener holds by default while the display is off or its client is frozen */
+#define LISTENER_HOLD_DEFAULT_LIMIT 8192
+/* how long a frozen listener waits for a drain before it checks its queue itself */
+#define LISTENER_RESUME_RETRY_MS 100
 
 namespace sensor {
 
@@ -36,10 +45,24 @@ public:
 	~sensor_listener_proxy();
 
 	uint32_t get_id(void);
+	ipc::channel *get_channel(void);
+	void set_client(const std::string &client);
+	int32_t get_sensor_id(void);
+
+	/* while set, events go to the group's stream instead of this channel */
+	void set_merger(event_merger *merger);
+	event_merger *get_merger(void);
 
 	/* sensor observer */
-	int update(const char *uri, std::shared_ptr<ipc::message> msg);
+	int update(int32_t id, std::shared_ptr<ipc::message> msg);
 	int on_attribute_changed(std::shared_ptr<ipc::message> msg);
+	void post_attribute_changed(uint32_t id, int32_t attribute, int32_t value);
+	void post_attribute_changed(uint32_t id, int32_t attribute, const char *value, int len);
+
+	/* the most samples a listener holds, the oldest ones are dropped beyond it */
+	static void set_hold_limit(size_t limit);
+	/* the outbound queue of the listener's channel has been written out */
+	void drained(void);
 
 	int start(bool policy = false);
 	int stop(bool policy = false);
@@ -50,12 +73,16 @@ public:
 	int get_max_batch_latency(int32_t& max_batch_latency);
 	int delete_batch_latency(void);
 	int set_passive_mode(bool passive);
+	bool get_passive_mode(void);
 	int set_attribute(int32_t attribute, int32_t value);
 	int get_attribute(int32_t attribute, int32_t *value);
 	int set_attribute(int32_t attribute, const char *value, int len);
 	int get_attribute(int32_t attribute, char **value, int *len);
 	int flush(void);
 	int get_data(sensor_data_t **data, int *len);
+	int get_latest_data(sensor_data_t *data);
+	int get_data_history(unsigned long long start_time, unsigned long long end_time,
+			int max_count, sensor_data_t **data, int *len);
 	std::string get_required_privileges(void);
 
 	/* sensor_policy_listener interface */
@@ -66,21 +93,101 @@ public:
 	void set_need_to_notify_attribute_changed(bool value);
 
 private:
+	sensor_handler *get_sensor(void);
+	void deliver(std::shared_ptr<ipc::message> msg);
+	bool is_frozen(size_t pending = 0);
+	void hold(int reason);
+	void release(int reason);
+	bool keep(std::shared_ptr<ipc::message> msg);
+	void resume(void);
+	void cancel_resume(void);
+	static void resume_timeout(uint64_t id, void *data);
+	const sensor_data_t *decimate(const sensor_data_t *data);
+	void reset_decimation(void);
+	int update_filter(int32_t type, int32_t cutoff);
+	const sensor_data_t *aggregate(const sensor_data_t *data);
+	void reset_aggregation(void);
+	bool is_change_filtered(void);
+	bool has_changed(const sensor_data_t *data);
+	void reset_change_filter(void);
+	bool batch(const sensor_data_t *data);
+	void flush_batch(void);
+	void cancel_batch(void);
+	std::shared_ptr<ipc::message> create_event(size_t capacity);
+	unsigned long long get_deadline(std::shared_ptr<ipc::message> msg);
+	static void batch_timeout(uint64_t id, void *data);
 	void update_event(std::shared_ptr<ipc::message> msg);
 	void update_accuracy(std::shared_ptr<ipc::message> msg);
 	void apply_sensor_handler_need_to_notify_attribute_changed(sensor_handler* handler);
 
 	uint32_t m_id;
 	std::string m_uri;
+	int32_t m_sensor_id;
+	bool m_remappable;
+	bool m_wakeup;
 
 	sensor_manager *m_manager;
 	ipc::channel *m_ch;
+	client_budget *m_budget;
+	event_merger *m_merger;
 
 	bool m_started;
 	bool m_passive;
+
+	/* non-wakeup events are kept here while the display is off or the client is frozen,
+	 * m_hold is a mask of the reasons */
+	int m_hold;
+	std::deque<sensor_data_t> m_held;
+	uint64_t m_hold_dropped;
+	static size_t m_hold_limit;
+
 	int32_t m_pause_policy;
 	int32_t m_axis_orientation;
 	int32_t m_last_accuracy;
+
+	/* per-listener decimation, m_interval is in ms, timestamps in us */
+	int32_t m_decimation;
+	int32_t m_interval;
+	unsigned long long m_next_timestamp;
+	sensor_data_t m_sum;
+	sensor_data_t m_avg;
+	int m_sum_count;
+
+	/* filter stage shared with the listeners of the same sensor and parameters */
+	int32_t m_filter_type;
+	int32_t m_filter_cutoff;
+	sensor_filter *m_filter;
+
+	/* per-listener window statistics, m_window is in ms */
+	int32_t m_aggregation;
+	int32_t m_window;
+	unsigned long long m_window_start;
+	int m_window_count;
+	int m_window_axes;
+	double m_window_sum[SENSOR_DATA_VALUE_SIZE];
+	double m_window_sq_sum[SENSOR_DATA_VALUE_SIZE];
+	float m_window_min[SENSOR_DATA_VALUE_SIZE];
+	float m_window_max[SENSOR_DATA_VALUE_SIZE];
+	sensor_data_t m_summary;
+
+	/* per-listener change filter, thresholds are in 1/1000 */
+	int32_t m_report_mode;
+	int32_t m_abs_threshold;
+	int32_t m_rel_threshold;
+	sensor_data_t m_last_reported;
+	bool m_reported;
+
+	/* per-listener batching, flushed when m_batch_latency (ms) expires or m_batch is full */
+	int32_t m_batch_latency;
+	std::shared_ptr<ipc::message> m_batch;
+	uint64_t m_batch_timer;
+	uint64_t m_resume_timer;
+
+	/* sensord_attribute_change_e types this listener is notified of */
+	int32_t m_attr_changes;
+
+	/* delivery deadline (ms) after the sample time, 0 is best effort */
+	int32_t m_deadline;
 	bool m_need_to_notify_attribute_changed;
 };
 
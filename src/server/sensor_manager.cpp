@@ -44,6 +44,10 @@ using namespace sensor;
 #define VIRTUAL_SENSOR_DIR_PATH LIBDIR "/sensor/fusion"
 #define EXTERNAL_SENSOR_DIR_PATH LIBDIR "/sensor/external"
 
+/* HAL events are dispatched ahead of client commands,
+ * but all HAL devices together yield once every HAL_EVENT_BUDGET consecutive wakeups */
+#define HAL_EVENT_BUDGET 8
+
 static device_sensor_registry_t devices;
 static physical_sensor_registry_t physical_sensors;
 static fusion_sensor_registry_t fusion_sensors;
@@ -90,6 +94,8 @@ bool sensor_manager::deinit(void)
 	for (auto it = m_sensors.begin(); it != m_sensors.end(); ++it)
 		delete it->second;
 	m_sensors.clear();
+	m_sensor_table.clear();
+	m_sensor_ids.clear();
 
 	external_sensors.clear();
 	fusion_sensors.clear();
@@ -177,7 +183,7 @@ bool sensor_manager::register_sensor(sensor_handler *sensor)
 	auto it = m_sensors.find(info.get_uri());
 	retvm_if(it != m_sensors.end(), false, "There is already a sensor with the same name");
 
-	m_sensors[info.get_uri()] = sensor;
+	add_sensor(info.get_uri(), sensor);
 
 	send_added_msg(&info);
 
@@ -191,6 +197,10 @@ void sensor_manager::deregister_sensor(const std::string uri)
 	auto it = m_sensors.find(uri);
 	ret_if(it == m_sensors.end());
 
+	int32_t id = it->second->get_id();
+	if (id >= 0 && (size_t)id < m_sensor_table.size())
+		m_sensor_table[id] = NULL;
+
 	delete it->second;
 	m_sensors.erase(it);
 
@@ -242,6 +252,31 @@ sensor_handler *sensor_manager::get_sensor(const std::string uri)
 	return m_sensors[uri];
 }
 
+sensor_handler *sensor_manager::get_sensor(int32_t id)
+{
+	retv_if(id < 0 || (size_t)id >= m_sensor_table.size(), NULL);
+
+	return m_sensor_table[id];
+}
+
+void sensor_manager::add_sensor(const std::string &uri, sensor_handler *sensor)
+{
+	int32_t id;
+	auto it = m_sensor_ids.find(uri);
+
+	if (it != m_sensor_ids.end()) {
+		id = it->second;
+	} else {
+		id = m_sensor_table.size();
+		m_sensor_table.push_back(NULL);
+		m_sensor_ids[uri] = id;
+	}
+
+	sensor->set_id(id);
+	m_sensor_table[id] = sensor;
+	m_sensors[uri] = sensor;
+}
+
 std::vector<sensor_handler *> sensor_manager::get_sensors(void)
 {
 	std::vector<sensor_handler *> sensors;
@@ -286,7 +321,7 @@ void sensor_manager::create_physical_sensors(device_sensor_registry_t &devices,
 					info[i], it->get(), info[i].id, sensor);
 			retm_if(!psensor, "Failed to allocate memory");
 
-			m_sensors[uri] = psensor;
+			add_sensor(uri, psensor);
 		}
 	}
 }
@@ -324,7 +359,7 @@ void sensor_manager::create_fusion_sensors(fusion_sensor_registry_t &fsensors)
 		}
 
 		sensor_info sinfo = fsensor->get_sensor_info();
-		m_sensors[sinfo.get_uri()] = fsensor;
+		add_sensor(sinfo.get_uri(), fsensor);
 
 		(*it)->set_fusion_sensor_handler(fsensor);
 	}
@@ -342,7 +377,7 @@ void sensor_manager::create_external_sensors(external_sensor_registry_t &esensor
 		retm_if(!esensor, "Failed to allocate memory");
 
 		sensor_info sinfo = esensor->get_sensor_info();
-		m_sensors[sinfo.get_uri()] = esensor;
+		add_sensor(sinfo.get_uri(), esensor);
 	}
 }
 
@@ -426,7 +461,8 @@ void sensor_manager::register_handler(physical_sensor_handler *sensor)
 	handler->add_sensor(sensor);
 	m_event_handlers[fd] = handler;
 
-	if (m_loop->add_event(fd, ipc::EVENT_IN | ipc::EVENT_HUP | ipc::EVENT_NVAL, handler) == 0) {
+	if (m_loop->add_event(fd, ipc::EVENT_IN | ipc::EVENT_HUP | ipc::EVENT_NVAL, handler,
+			ipc::EVENT_PRIORITY_HIGH, HAL_EVENT_BUDGET) == 0) {
 		_D("Failed to add sensor event handler");
 		handler->remove_sensor(sensor);
 
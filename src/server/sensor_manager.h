@@ -56,6 +56,7 @@ public:
 
 	sensor_handler *get_sensor_by_type(const std::string uri);
 	sensor_handler *get_sensor(const std::string uri);
+	sensor_handler *get_sensor(int32_t id);
 	std::vector<sensor_handler *> get_sensors(void);
 
 	size_t serialize(int sock_fd, char **bytes);
@@ -69,6 +70,8 @@ private:
 	void create_fusion_sensors(fusion_sensor_registry_t &vsensors);
 	void create_external_sensors(external_sensor_registry_t &vsensors);
 
+	void add_sensor(const std::string &uri, sensor_handler *sensor);
+
 	void init_sensors(void);
 	void register_handler(physical_sensor_handler *sensor);
 
@@ -84,6 +87,10 @@ private:
 	sensor_loader m_loader;
 	sensor_map_t m_sensors;
 
+	/* every uri gets a dense id once, kept if the sensor is registered again */
+	std::map<std::string, int32_t> m_sensor_ids;
+	std::vector<sensor_handler *> m_sensor_table;
+
 	std::vector<ipc::channel *> m_channels;
 	std::map<int, sensor_event_handler *> m_event_handlers;
 };
@@ -28,7 +28,8 @@ class sensor_observer {
 public:
 	virtual ~sensor_observer() {}
 
-	virtual int update(const char *uri, std::shared_ptr<ipc::message> msg) = 0;
+	/* id is the dense id the sensor manager gave to the publishing sensor */
+	virtual int update(int32_t id, std::shared_ptr<ipc::message> msg) = 0;
 };
 
 }
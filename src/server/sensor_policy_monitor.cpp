@@ -36,7 +36,8 @@ static int get_power_save_state(void)
 
 	ret = vconf_get_int(VCONFKEY_PM_STATE, &pm_state);
 
-	if (!ret && pm_state == VCONFKEY_PM_STATE_LCDOFF)
+	/* the display is off in sleep as well */
+	if (!ret && (pm_state == VCONFKEY_PM_STATE_LCDOFF || pm_state == VCONFKEY_PM_STATE_SLEEP))
 		state |= SENSORD_PAUSE_ON_DISPLAY_OFF;
 
 	ret = vconf_get_int(VCONFKEY_SETAPPL_PSMODE, &ps_state);
@@ -21,13 +21,25 @@
 
 #include <unistd.h>
 #include <sys/stat.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
 #include <systemd/sd-daemon.h>
+#include <libsyscommon/ini-parser.h>
 #include <sensor_log.h>
 #include <command_types.h>
 #include <ipc_server.h>
+#include <thread_policy.h>
+#include <sensor_history.h>
+#include <flight_recorder.h>
+#include <glib-unix.h>
+#include <signal.h>
 
 #include "sensor_manager.h"
 #include "server_channel_handler.h"
+#include "dbus_listener.h"
+#include "client_budget.h"
+#include "sensor_listener_proxy.h"
 
 #define MAX_CONFIG_PATH 255
 #define CAL_CONFIG_PATH "/etc/sensor_cal.conf"
@@ -36,8 +48,102 @@
 
 #define MAX_CONNECTION 1000
 
+#define SERVER_CONFIG_PATH "/etc/sensord/sensord.conf"
+#define MAIN_THREAD_NAME "sensord"
+#define FLIGHT_RECORDER_RECORDS 4096
+#define BUDGET_CLIENT_LEN 255
+#define BUDGET_CLIENT_FMT "255"
+
 using namespace sensor;
 
+/* Client=<smack label> <rate> [<burst>] */
+struct budget_override {
+	std::string client;
+	unsigned int rate;
+	unsigned int burst;
+};
+
+struct server_config {
+	unsigned int stall_threshold;
+	unsigned int timer_slack;
+	unsigned int lock_sampling_rate;
+	unsigned int history_depth;
+	unsigned int hold_limit;
+	unsigned int budget_rate;
+	unsigned int budget_burst;
+	std::vector<budget_override> budget_overrides;
+	std::string budget_shared_labels;
+	int flight_records;
+	std::string flight_path;
+	thread_policy main_thread;
+};
+
+static struct server_config server_conf;
+
+static void parse_budget_override(struct server_config *c, const char *value)
+{
+	char client[BUDGET_CLIENT_LEN + 1];
+	budget_override o = {"", 0, 0};
+
+	retm_if(sscanf(value, "%" BUDGET_CLIENT_FMT "s %u %u", client, &o.rate, &o.burst) < 2,
+			"Invalid client budget[%s]", value);
+
+	o.client = client;
+	c->budget_overrides.push_back(o);
+}
+
+static int server_load_config(struct parse_result *result, void *user_data)
+{
+	struct server_config *c = (struct server_config *)user_data;
+
+	if (MATCH(result->section, "EventLoop")) {
+		if (MATCH(result->name, "StallThreshold"))
+			SET_CONF(c->stall_threshold, atoi(result->value));
+		else if (MATCH(result->name, "TimerSlack"))
+			SET_CONF(c->timer_slack, atoi(result->value));
+	} else if (MATCH(result->section, "Lock")) {
+		if (MATCH(result->name, "ProfileSamplingRate"))
+			SET_CONF(c->lock_sampling_rate, atoi(result->value));
+	} else if (MATCH(result->section, "SensorHistory")) {
+		if (MATCH(result->name, "Depth"))
+			SET_CONF(c->history_depth, atoi(result->value));
+		else if (MATCH(result->name, "HoldLimit"))
+			SET_CONF(c->hold_limit, atoi(result->value));
+	} else if (MATCH(result->section, "ClientBudget")) {
+		if (MATCH(result->name, "Rate"))
+			SET_CONF(c->budget_rate, atoi(result->value));
+		else if (MATCH(result->name, "Burst"))
+			SET_CONF(c->budget_burst, atoi(result->value));
+		else if (MATCH(result->name, "Client"))
+			parse_budget_override(c, result->value);
+		else if (MATCH(result->name, "SharedLabels"))
+			c->budget_shared_labels = result->value;
+	} else if (MATCH(result->section, "FlightRecorder")) {
+		/* 0 turns the recorder off */
+		if (MATCH(result->name, "Records"))
+			c->flight_records = atoi(result->value);
+		else if (MATCH(result->name, "Path"))
+			c->flight_path = result->value;
+	} else if (MATCH(result->section, "MainThread")) {
+		if (MATCH(result->name, "CpuAffinity"))
+			c->main_thread.set_cpus(result->value);
+		else if (MATCH(result->name, "Nice"))
+			c->main_thread.set_nice(atoi(result->value));
+		else if (MATCH(result->name, "Scheduler"))
+			c->main_thread.set_scheduler(result->value);
+		else if (MATCH(result->name, "Priority"))
+			c->main_thread.set_priority(atoi(result->value));
+	}
+
+	return 0;
+}
+
+static gboolean dump_flight_recorder(gpointer data)
+{
+	flight_recorder::dump();
+	return G_SOURCE_CONTINUE;
+}
+
 ipc::event_loop server::m_loop;
 std::atomic<bool> server::is_running(false);
 
@@ -85,6 +191,7 @@ bool server::init(void)
 	m_handler = new(std::nothrow) server_channel_handler(m_manager);
 	retvm_if(!m_handler, false, "Failed to allocate memory");
 
+	init_config();
 	init_calibration();
 	init_server();
 
@@ -133,6 +240,47 @@ static void set_cal_data(const char *path)
 	_I("Succeeded to set calibration data");
 }
 
+void server::init_config(void)
+{
+	server_conf.flight_records = FLIGHT_RECORDER_RECORDS;
+	server_conf.flight_path = FLIGHT_RECORDER_PATH;
+
+	int ret = config_parse(SERVER_CONFIG_PATH, server_load_config, &server_conf);
+	if (ret < 0)
+		_D("Failed to load '%s', so use default config", SERVER_CONFIG_PATH);
+
+	m_loop.set_stall_threshold(server_conf.stall_threshold);
+
+	if (server_conf.timer_slack)
+		m_loop.set_timer_slack(server_conf.timer_slack);
+
+	if (server_conf.lock_sampling_rate)
+		lock_profiler::set_sampling_rate(server_conf.lock_sampling_rate);
+
+	/* sensors are created later by the manager and take this depth */
+	sensor_history::set_default_depth(server_conf.history_depth);
+
+	/* samples each listener keeps while the display is off or its client is frozen */
+	if (server_conf.hold_limit)
+		sensor_listener_proxy::set_hold_limit(server_conf.hold_limit);
+
+	/* events per second each client may receive, by default and per smack label */
+	if (server_conf.budget_rate)
+		client_budget::set_limit(server_conf.budget_rate, server_conf.budget_burst);
+	for (auto &it : server_conf.budget_overrides)
+		client_budget::set_limit(it.client, it.rate, it.burst);
+	if (!server_conf.budget_shared_labels.empty())
+		client_budget::set_shared_labels(server_conf.budget_shared_labels);
+
+	/* always on, dumped on SIGUSR2 or by "sensorctl recorder dump" */
+	if (server_conf.flight_records > 0)
+		flight_recorder::set_capacity(server_conf.flight_records);
+	flight_recorder::set_path(server_conf.flight_path.c_str());
+
+	/* the main thread runs the event loop */
+	server_conf.main_thread.apply(MAIN_THREAD_NAME);
+}
+
 void server::init_calibration(void)
 {
 	char path[MAX_CONFIG_PATH];
@@ -157,4 +305,10 @@ void server::init_server(void)
 	m_server->set_option("max_connection", MAX_CONNECTION);
 	m_server->set_option(SO_TYPE, SOCK_STREAM);
 	m_server->bind(m_handler, &m_loop);
+
+	/* display rotation for display oriented listeners */
+	dbus_listener::init();
+
+	/* the dump runs in the loop, not in the signal handler */
+	g_unix_signal_add(SIGUSR2, dump_flight_recorder, NULL);
 }
@@ -44,6 +44,7 @@ private:
 	bool init(void);
 	void deinit(void);
 
+	void init_config(void);
 	void init_calibration(void);
 	void init_server(void);
 
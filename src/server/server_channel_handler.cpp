@@ -19,6 +19,9 @@
 
 #include "server_channel_handler.h"
 
+#include <unistd.h>
+#include <sys/socket.h>
+#include <map>
 #include <sensor_log.h>
 #include <sensor_info.h>
 #include <sensor_handler.h>
@@ -26,11 +29,15 @@
 #include <sensor_types_private.h>
 #include <command_types.h>
 #include <event_loop.h>
+#include <flight_recorder.h>
 
 #include "permission_checker.h"
+#include "event_stats.h"
+#include "client_budget.h"
 #include "application_sensor_handler.h"
 
 #define CONVERT_ATTR_TYPE(attr) ((attr) >> 8)
+#define SMACK_LABEL_LEN 255
 
 using namespace sensor;
 using namespace ipc;
@@ -38,6 +45,7 @@ using namespace ipc;
 /* TODO */
 std::unordered_map<uint32_t, sensor_listener_proxy *> server_channel_handler::m_listeners;
 std::unordered_map<ipc::channel *, uint32_t> server_channel_handler::m_listener_ids;
+std::unordered_map<ipc::channel *, event_merger *> server_channel_handler::m_groups;
 std::unordered_map<ipc::channel *, application_sensor_handler *> server_channel_handler::m_app_sensors;
 
 server_channel_handler::server_channel_handler(sensor_manager *manager)
@@ -55,6 +63,18 @@ void server_channel_handler::connected(channel *ch)
 {
 }
 
+/* a frozen listener gets what it holds once its client has caught up */
+void server_channel_handler::drained(channel *ch)
+{
+	auto id = m_listener_ids.find(ch);
+	ret_if(id == m_listener_ids.end());
+
+	auto it = m_listeners.find(id->second);
+	ret_if(it == m_listeners.end());
+
+	it->second->drained();
+}
+
 void server_channel_handler::disconnected(channel *ch)
 {
 	_I("Disconnect[%p] using channel[%p]", this, ch);
@@ -79,6 +99,24 @@ void server_channel_handler::disconnected(channel *ch)
 		m_listener_ids.erase(ch);
 	}
 
+	auto it_group = m_groups.find(ch);
+	if (it_group != m_groups.end()) {
+		event_merger *group = it_group->second;
+
+		_I("Disconnected group[%u]", group->get_id());
+
+		/* the members go back to their own channels */
+		std::vector<uint32_t> members = group->get_members();
+		for (auto id : members) {
+			auto it = m_listeners.find(id);
+			if (it != m_listeners.end())
+				it->second->set_merger(NULL);
+		}
+
+		delete group;
+		m_groups.erase(ch);
+	}
+
 	if (!ch->loop())
 		_D("Should not be here : channel[%p]", ch);
 }
@@ -86,6 +124,7 @@ void server_channel_handler::disconnected(channel *ch)
 void server_channel_handler::read(channel *ch, message &msg)
 {
 	int err = -EINVAL;
+	unsigned long long start = utils::get_timestamp();
 
 	switch (msg.type()) {
 	case CMD_MANAGER_CONNECT:
@@ -96,6 +135,10 @@ void server_channel_handler::read(channel *ch, message &msg)
 		err = manager_set_attr_int(ch, msg); break;
 	case CMD_MANAGER_GET_ATTR_INT:
 		err = manager_get_attr_int(ch, msg); break;
+	case CMD_MANAGER_GET_STATS:
+		err = manager_get_stats(ch, msg); break;
+	case CMD_MANAGER_SNAPSHOT:
+		err = manager_snapshot(ch, msg); break;
 	case CMD_LISTENER_CONNECT:
 		err = listener_connect(ch, msg); break;
 	case CMD_LISTENER_START:
@@ -114,6 +157,8 @@ void server_channel_handler::read(channel *ch, message &msg)
 		err = listener_get_attr_str(ch, msg); break;
 	case CMD_LISTENER_GET_DATA_LIST:
 		err = listener_get_data_list(ch, msg); break;
+	case CMD_LISTENER_GROUP_CONNECT:
+		err = listener_group_connect(ch, msg); break;
 	case CMD_PROVIDER_CONNECT:
 		err = provider_connect(ch, msg); break;
 	case CMD_PROVIDER_PUBLISH:
@@ -123,6 +168,9 @@ void server_channel_handler::read(channel *ch, message &msg)
 	default: break;
 	}
 
+	flight_recorder::record(FLIGHT_RECORD_COMMAND, msg.type(),
+			utils::get_timestamp() - start, err);
+
 	if (err != 0) {
 		message reply(err);
 		ch->send_sync(reply);
@@ -234,6 +282,129 @@ int server_channel_handler::manager_get_attr_int(channel *ch, message &msg)
 	return OP_SUCCESS;
 }
 
+int server_channel_handler::manager_get_stats(channel *ch, message &msg)
+{
+	cmd_manager_stats_t buf;
+	std::string stats;
+
+	/* server internals are for platform tools only */
+	retvm_if(!has_privileges(ch->get_fd(), PRIVILEGE_PLATFORM_URI), -EPERM,
+			"Permission denied[%s]", PRIVILEGE_PLATFORM_URI);
+
+	msg.disclose((char *)&buf, sizeof(buf));
+
+	switch (buf.type) {
+	case SENSORD_STATS_EVENT_LOOP:
+		retv_if(!ch->loop(), -EINVAL);
+		ch->loop()->get_profile(stats);
+		break;
+	case SENSORD_STATS_LOCK:
+		lock_profiler::get_stats(stats);
+		break;
+	case SENSORD_STATS_EVENT_COPY:
+		event_stats::get_stats(stats);
+		break;
+	case SENSORD_STATS_CLIENT_BUDGET:
+		client_budget::get_stats(stats);
+		break;
+	case SENSORD_STATS_FLIGHT_RECORDER: {
+		size_t count = 0;
+		retv_if(!flight_recorder::dump(&count), -EIO);
+		stats = "Dumped " + std::to_string(count) + " records to " + flight_recorder::get_path() + "\n";
+		break;
+	}
+	default:
+		return -EINVAL;
+	}
+
+	/* including null character */
+	size_t len = stats.size() + 1;
+	if (sizeof(cmd_manager_stats_t) + len > MAX_MSG_CAPACITY)
+		len = MAX_MSG_CAPACITY - sizeof(cmd_manager_stats_t);
+
+	size_t size = sizeof(cmd_manager_stats_t) + len;
+	cmd_manager_stats_t *reply_buf = (cmd_manager_stats_t *) new(std::nothrow) char[size];
+	retvm_if(!reply_buf, -ENOMEM, "Failed to allocate memory");
+
+	reply_buf->type = buf.type;
+	reply_buf->len = len;
+	memcpy(reply_buf->stats, stats.c_str(), len);
+	reply_buf->stats[len - 1] = '\0';
+
+	message reply;
+	reply.enclose((char *)reply_buf, size);
+	reply.header()->err = OP_SUCCESS;
+	reply.set_type(CMD_MANAGER_GET_STATS);
+
+	bool ret = ch->send_sync(reply);
+	delete [] reply_buf;
+
+	retv_if(!ret, OP_ERROR);
+
+	return OP_SUCCESS;
+}
+
+int server_channel_handler::manager_snapshot(channel *ch, message &msg)
+{
+	cmd_manager_snapshot_t *buf;
+	std::map<std::string, bool> allowed;
+
+	retv_if(msg.size() < sizeof(cmd_manager_snapshot_t), -EINVAL);
+	buf = (cmd_manager_snapshot_t *)msg.body();
+	retv_if(buf->count <= 0 || buf->count > MAX_SNAPSHOT_COUNT, -EINVAL);
+
+	size_t size = sizeof(cmd_manager_snapshot_t) +
+			sizeof(cmd_manager_snapshot_entry_t) * buf->count;
+	retv_if(msg.size() < size, -EINVAL);
+
+	cmd_manager_snapshot_t *reply_buf = (cmd_manager_snapshot_t *) new(std::nothrow) char[size];
+	retvm_if(!reply_buf, -ENOMEM, "Failed to allocate memory");
+
+	/* all histories are read within this single dispatch, so no event can land in between */
+	reply_buf->count = buf->count;
+	for (int i = 0; i < buf->count; ++i) {
+		cmd_manager_snapshot_entry_t &entry = reply_buf->entries[i];
+		uint32_t id = buf->entries[i].listener_id;
+
+		memset(&entry, 0, sizeof(entry));
+		entry.listener_id = id;
+
+		auto it = m_listeners.find(id);
+		if (it == m_listeners.end()) {
+			entry.err = -EINVAL;
+			continue;
+		}
+
+		/* several listeners usually share a privilege, ask cynara once per privilege */
+		std::string privilege = it->second->get_required_privileges();
+		auto checked = allowed.find(privilege);
+		if (checked == allowed.end())
+			checked = allowed.insert(std::make_pair(privilege,
+					has_privileges(ch->get_fd(), privilege))).first;
+
+		if (!checked->second) {
+			_E("Permission denied[%d, %s]", id, privilege.c_str());
+			entry.err = -EACCES;
+			continue;
+		}
+
+		/* a snapshot only peeks, the samples stay there for sensord_get_data() */
+		entry.err = it->second->get_latest_data(&entry.data);
+	}
+
+	message reply;
+	reply.enclose((char *)reply_buf, size);
+	reply.header()->err = OP_SUCCESS;
+	reply.set_type(CMD_MANAGER_SNAPSHOT);
+
+	bool ret = ch->send_sync(reply);
+	delete [] reply_buf;
+
+	retv_if(!ret, OP_ERROR);
+
+	return OP_SUCCESS;
+}
+
 int server_channel_handler::listener_connect(channel *ch, message &msg)
 {
 	static uint32_t listener_id = 1;
@@ -251,6 +422,11 @@ int server_channel_handler::listener_connect(channel *ch, message &msg)
 
 	buf.listener_id = listener_id;
 
+	/* listeners of the same client share its event budget */
+	std::string client;
+	if (get_client(ch->get_fd(), client))
+		listener->set_client(client);
+
 	message reply;
 	reply.set_type(CMD_LISTENER_CONNECTED);
 	reply.enclose((const char *)&buf, sizeof(buf));
@@ -262,6 +438,7 @@ int server_channel_handler::listener_connect(channel *ch, message &msg)
 	_I("Connected sensor_listener[fd(%d) -> id(%u)]", ch->get_fd(), listener_id);
 	m_listeners[listener_id] = listener;
 	m_listener_ids[ch] = listener_id;
+	flight_recorder::record(FLIGHT_RECORD_CONNECT, listener_id, ch->get_fd(), listener->get_sensor_id());
 	listener_id++;
 
 	return OP_SUCCESS;
@@ -404,9 +581,7 @@ int server_channel_handler::listener_get_attr_int(ipc::channel *ch, ipc::message
 	case SENSORD_ATTRIBUTE_MAX_BATCH_LATENCY:
 		ret = m_listeners[id]->get_max_batch_latency(value); break;
 	case SENSORD_ATTRIBUTE_PASSIVE_MODE:
-		// TODO : Are these features required?
-		ret = OP_ERROR;
-		break;
+		value = m_listeners[id]->get_passive_mode(); break;
 	case SENSORD_ATTRIBUTE_PAUSE_POLICY:
 	case SENSORD_ATTRIBUTE_AXIS_ORIENTATION:
 	default:
@@ -505,7 +680,9 @@ int server_channel_handler::listener_get_data(channel *ch, message &msg)
 	int ret = m_listeners[id]->get_data(&data, &len);
 	retv_if(ret < 0, ret);
 
-	memcpy(&buf.data, data, sizeof(sensor_data_t));
+	/* the last event may hold several samples, return the newest */
+	int count = len / sizeof(sensor_data_t);
+	memcpy(&buf.data, count > 1 ? &data[count - 1] : data, sizeof(sensor_data_t));
 	buf.len = sizeof(sensor_data_t);
 
 	reply.enclose((const char *)&buf, sizeof(cmd_listener_get_data_t));
@@ -536,7 +713,14 @@ int server_channel_handler::listener_get_data_list(ipc::channel *ch, ipc::messag
 			-EACCES, "Permission denied[%d, %s]",
 			id, m_listeners[id]->get_required_privileges().c_str());
 
-	int ret = m_listeners[id]->get_data(&data, &len);
+	int ret;
+	if (buf.start_time || buf.end_time) {
+		/* the reply has to fit in a single message */
+		int max_count = (MAX_MSG_CAPACITY - 1 - sizeof(cmd_listener_get_data_list_t)) / sizeof(sensor_data_t);
+		ret = m_listeners[id]->get_data_history(buf.start_time, buf.end_time, max_count, &data, &len);
+	} else {
+		ret = m_listeners[id]->get_data(&data, &len);
+	}
 	retv_if(ret < 0, ret);
 
 	size_t reply_size = sizeof(cmd_listener_get_data_list_t) + len;
@@ -550,6 +734,8 @@ int server_channel_handler::listener_get_data_list(ipc::channel *ch, ipc::messag
 	memcpy(reply_buf->data, data, len);
 	reply_buf->len = len;
 	reply_buf->data_count = len / sizeof(sensor_data_t);
+	reply_buf->start_time = buf.start_time;
+	reply_buf->end_time = buf.end_time;
 	reply.enclose((const char *)reply_buf, reply_size);
 	reply.header()->err = OP_SUCCESS;
 	reply.header()->type = CMD_LISTENER_GET_DATA_LIST;
@@ -563,6 +749,68 @@ int server_channel_handler::listener_get_data_list(ipc::channel *ch, ipc::messag
 
 }
 
+int server_channel_handler::listener_group_connect(channel *ch, message &msg)
+{
+	static uint32_t group_id = 1;
+	cmd_listener_group_connect_t buf;
+
+	msg.disclose((char *)&buf, sizeof(buf));
+	retv_if(buf.count <= 0 || buf.count > MAX_GROUP_MEMBERS, -EINVAL);
+	retv_if(buf.window <= 0, -EINVAL);
+	retv_if(m_groups.find(ch) != m_groups.end(), -EINVAL);
+
+	for (int i = 0; i < buf.count; ++i) {
+		uint32_t id = buf.listener_id[i];
+
+		auto it = m_listeners.find(id);
+		retv_if(it == m_listeners.end(), -EINVAL);
+
+		/* only the client that connected a listener may group it */
+		channel *owner = it->second->get_channel();
+		retvm_if(!owner || (owner != ch && !is_same_peer(ch->get_fd(), owner->get_fd())),
+				-EACCES, "Listener[%u] belongs to another client", id);
+
+		retvm_if(it->second->get_merger(), -EBUSY, "Listener[%u] is already grouped", id);
+		retvm_if(!has_privileges(ch->get_fd(), it->second->get_required_privileges()),
+				-EACCES, "Permission denied[%d, %s]",
+				id, it->second->get_required_privileges().c_str());
+
+		buf.sensor_id[i] = it->second->get_sensor_id();
+		retv_if(buf.sensor_id[i] < 0, -EINVAL);
+
+		/* the sensor id tags the events, so it has to be unique in the group */
+		for (int j = 0; j < i; ++j)
+			retvm_if(buf.sensor_id[j] == buf.sensor_id[i], -EINVAL,
+					"Sensor[%d] is already in the group", buf.sensor_id[i]);
+	}
+
+	event_merger *group = new(std::nothrow) event_merger(group_id, ch, buf.window);
+	retvm_if(!group, -ENOMEM, "Failed to allocate memory");
+
+	buf.group_id = group_id;
+
+	message reply;
+	reply.set_type(CMD_LISTENER_GROUP_CONNECT);
+	reply.enclose((const char *)&buf, sizeof(buf));
+	reply.header()->err = OP_SUCCESS;
+
+	if (!ch->send_sync(reply)) {
+		delete group;
+		return OP_ERROR;
+	}
+
+	for (int i = 0; i < buf.count; ++i) {
+		group->add_member(buf.listener_id[i], buf.sensor_id[i]);
+		m_listeners[buf.listener_id[i]]->set_merger(group);
+	}
+
+	_I("Connected group[fd(%d) -> id(%u)] of %d listeners", ch->get_fd(), group_id, buf.count);
+	m_groups[ch] = group;
+	group_id++;
+
+	return OP_SUCCESS;
+}
+
 int server_channel_handler::provider_connect(channel *ch, message &msg)
 {
 	sensor_info info;
@@ -625,6 +873,67 @@ int server_channel_handler::send_reply(channel *ch, int error)
 	return OP_SUCCESS;
 }
 
+/* the smack label of the peer, it is empty without smack */
+static std::string get_peer_label(int fd)
+{
+	char label[SMACK_LABEL_LEN + 1];
+	socklen_t len = SMACK_LABEL_LEN;
+
+	retv_if(getsockopt(fd, SOL_SOCKET, SO_PEERSEC, label, &len) < 0 || len == 0, "");
+
+	label[len] = '\0';
+	return label;
+}
+
+static bool get_peer_pid(int fd, pid_t &pid)
+{
+	struct ucred cred;
+	socklen_t len = sizeof(cred);
+
+	retvm_if(getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) < 0, false,
+			"Failed to get credentials of fd[%d]", fd);
+
+	pid = cred.pid;
+	return true;
+}
+
+/*
+ * A client is its smack label, which every process of an application shares,
+ * or the label and the pid for shared platform labels. Without a label, it is
+ * the session of the peer, which forked children keep.
+ */
+bool server_channel_handler::get_client(int fd, std::string &client)
+{
+	pid_t pid;
+	std::string label = get_peer_label(fd);
+
+	if (!get_peer_pid(fd, pid)) {
+		client = label;
+		return !label.empty();
+	}
+
+	if (!label.empty()) {
+		client = client_budget::get_client(label, pid);
+		return true;
+	}
+
+	pid_t sid = getsid(pid);
+	client = "sid:" + std::to_string(sid < 0 ? pid : sid);
+
+	return true;
+}
+
+/* both sockets are connected by the same process, running with the same label */
+bool server_channel_handler::is_same_peer(int fd, int other)
+{
+	pid_t pid, other_pid;
+
+	retv_if(!get_peer_pid(fd, pid) || !get_peer_pid(other, other_pid), false);
+	retv_if(pid != other_pid, false);
+
+	return get_peer_label(fd) == get_peer_label(other);
+}
+
 bool server_channel_handler::has_privilege(int fd, std::string &priv)
 {
 	static permission_checker checker;
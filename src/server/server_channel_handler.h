@@ -28,6 +28,7 @@
 #include "sensor_manager.h"
 #include "sensor_listener_proxy.h"
 #include "application_sensor_handler.h"
+#include "event_merger.h"
 #include "command_types.h"
 
 namespace sensor {
@@ -45,6 +46,7 @@ public:
 	void error_caught(ipc::channel *ch, int error) {}
 	void set_handler(int num, ipc::channel_handler* handler) {}
 	void disconnect(void) {}
+	void drained(ipc::channel *ch);
 
 private:
 	int manager_connect(ipc::channel *ch, ipc::message &msg);
@@ -54,6 +56,8 @@ private:
 					sensor_handler **sensor);
 	int manager_set_attr_int(ipc::channel *ch, ipc::message &msg);
 	int manager_get_attr_int(ipc::channel *ch, ipc::message &msg);
+	int manager_get_stats(ipc::channel *ch, ipc::message &msg);
+	int manager_snapshot(ipc::channel *ch, ipc::message &msg);
 
 	int listener_connect(ipc::channel *ch, ipc::message &msg);
 	int listener_disconnect(ipc::channel *ch, ipc::message &msg);
@@ -65,6 +69,7 @@ private:
 	int listener_get_attr_int(ipc::channel *ch, ipc::message &msg);
 	int listener_get_attr_str(ipc::channel *ch, ipc::message &msg);
 	int listener_get_data_list(ipc::channel *ch, ipc::message &msg);
+	int listener_group_connect(ipc::channel *ch, ipc::message &msg);
 
 	int provider_connect(ipc::channel *ch, ipc::message &msg);
 	int provider_disconnect(ipc::channel *ch, ipc::message &msg);
@@ -75,6 +80,9 @@ private:
 	bool has_privilege(int fd, std::string &priv);
 	bool has_privileges(int fd, std::string priv);
 
+	bool get_client(int fd, std::string &client);
+	bool is_same_peer(int fd, int other);
+
 	int send_reply(ipc::channel *ch, int error);
 
 	sensor_manager *m_manager;
@@ -85,6 +93,9 @@ private:
 	/* {channel, id} */
 	static std::unordered_map<ipc::channel *, uint32_t> m_listener_ids;
 
+	/* {channel, group} */
+	static std::unordered_map<ipc::channel *, event_merger *> m_groups;
+
 	/* {channel, application_sensor_handler} */
 	/* it should move to sensor_manager */
 	static std::unordered_map<ipc::channel *, application_sensor_handler *> m_app_sensors;
@@ -19,13 +19,77 @@
 
 #include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <errno.h>
+#include <time.h>
 #include <sys/time.h>
 #include <cbase_lock.h>
 #include <sensor_log.h>
 
+#define LOCK_PROFILE_ENV "SENSOR_LOCK_PROFILE"
+#define LOCK_STATS_LINE_SIZE 512
+
 using namespace sensor;
 
+static unsigned int get_default_sampling_rate(void)
+{
+	const char *rate = getenv(LOCK_PROFILE_ENV);
+	retv_if(!rate, 0);
+
+	return strtoul(rate, NULL, 10);
+}
+
+static uint64_t get_monotonic_time(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+std::atomic<unsigned int> lock_profiler::m_sampling_rate(get_default_sampling_rate());
+std::atomic<lock_site *> lock_profiler::m_sites(nullptr);
+
+void lock_profiler::set_sampling_rate(unsigned int rate)
+{
+	m_sampling_rate.store(rate);
+	_I("Lock profiler sampling rate : %u", rate);
+}
+
+void lock_profiler::add_site(lock_site *site)
+{
+	bool expected = false;
+
+	if (!site->registered.compare_exchange_strong(expected, true))
+		return;
+
+	lock_site *head = m_sites.load();
+	do {
+		site->next = head;
+	} while (!m_sites.compare_exchange_weak(head, site));
+}
+
+void lock_profiler::get_stats(std::string &stats)
+{
+	char line[LOCK_STATS_LINE_SIZE];
+
+	snprintf(line, sizeof(line), "sampling rate : 1/%u\n", get_sampling_rate());
+	stats.append(line);
+	stats.append("site contended sampled avg_wait(us) max_wait(us)\n");
+
+	for (lock_site *site = m_sites.load(); site; site = site->next) {
+		uint64_t sampled = site->sampled.load();
+
+		snprintf(line, sizeof(line), "%s:%d(%s) %llu %llu %llu %llu\n",
+				site->file, site->line, site->expr,
+				(unsigned long long)site->contended.load(),
+				(unsigned long long)sampled,
+				(unsigned long long)(sampled ? site->wait.load() / sampled : 0),
+				(unsigned long long)site->max_wait.load());
+		stats.append(line);
+	}
+}
+
 cbase_lock::cbase_lock()
 {
 	m_history_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -88,6 +152,57 @@ void cbase_lock::lock(lock_type type, const char* expr, const char *module, cons
 	pthread_mutex_unlock(&m_history_mutex);
 }
 
+void cbase_lock::lock(lock_type type, lock_site *site)
+{
+	/* fast path : the lock itself, unless contention profiling is enabled */
+	if (lock_profiler::get_sampling_rate() == 0) {
+		lock(type);
+		return;
+	}
+
+	if (try_lock(type) == 0)
+		return;
+
+	lock_contended(type, site);
+}
+
+void cbase_lock::lock_contended(lock_type type, lock_site *site)
+{
+	unsigned int rate = lock_profiler::get_sampling_rate();
+	uint64_t count = site->contended.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	lock_profiler::add_site(site);
+
+	if (rate == 0 || count % rate != 0) {
+		lock(type);
+		return;
+	}
+
+	uint64_t start = get_monotonic_time();
+	lock(type);
+	uint64_t wait = get_monotonic_time() - start;
+
+	site->sampled.fetch_add(1, std::memory_order_relaxed);
+	site->wait.fetch_add(wait, std::memory_order_relaxed);
+
+	uint64_t max_wait = site->max_wait.load(std::memory_order_relaxed);
+	while (max_wait < wait &&
+			!site->max_wait.compare_exchange_weak(max_wait, wait, std::memory_order_relaxed)) {
+	}
+}
+
+int cbase_lock::try_lock(lock_type type)
+{
+	if (type == LOCK_TYPE_MUTEX)
+		return try_lock_impl();
+	else if (type == LOCK_TYPE_READ)
+		return try_read_lock_impl();
+	else if (type == LOCK_TYPE_WRITE)
+		return try_write_lock_impl();
+
+	return -EINVAL;
+}
+
 void cbase_lock::lock(lock_type type)
 {
 	if (type == LOCK_TYPE_MUTEX)
@@ -144,6 +259,12 @@ Autolock::Autolock(cbase_lock &m, lock_type type, const char* expr, const char *
 	m_lock.lock(type, expr, module, func, line);
 }
 
+Autolock::Autolock(cbase_lock &m, lock_type type, lock_site *site)
+: m_lock(m)
+{
+	m_lock.lock(type, site);
+}
+
 Autolock::Autolock(cbase_lock &m, lock_type type)
 : m_lock(m)
 {
@@ -21,6 +21,9 @@
 #define _CBASE_LOCK_H_
 
 #include <pthread.h>
+#include <stdint.h>
+#include <atomic>
+#include <string>
 
 namespace sensor {
 
@@ -43,21 +46,71 @@ enum lock_type {
 #define LOCK_W(x)	(x).lock(LOCK_TYPE_WRITE, #x, __MODULE__, __func__, __LINE__)
 #define UNLOCK(x)	(x).unlock()
 #else
-#define AUTOLOCK(x) Autolock x##_autolock((x), LOCK_TYPE_MUTEX)
-#define AUTOLOCK_R(x) Autolock x##_autolock_r((x), LOCK_TYPE_READ)
-#define AUTOLOCK_W(x) Autolock x##_autolock_w((x), LOCK_TYPE_WRITE)
-#define LOCK(x)		(x).lock()
-#define LOCK_R(x)	(x).lock(LOCK_TYPE_READ)
-#define LOCK_W(x)	(x).lock(LOCK_TYPE_WRITE)
+#define LOCK_SITE(x, site) static lock_site site(#x, __FILE__, __LINE__)
+#define AUTOLOCK(x) LOCK_SITE(x, x##_lock_site); Autolock x##_autolock((x), LOCK_TYPE_MUTEX, &x##_lock_site)
+#define AUTOLOCK_R(x) LOCK_SITE(x, x##_lock_site_r); Autolock x##_autolock_r((x), LOCK_TYPE_READ, &x##_lock_site_r)
+#define AUTOLOCK_W(x) LOCK_SITE(x, x##_lock_site_w); Autolock x##_autolock_w((x), LOCK_TYPE_WRITE, &x##_lock_site_w)
+#define LOCK(x)		do { LOCK_SITE(x, x##_lock_site); (x).lock(LOCK_TYPE_MUTEX, &x##_lock_site); } while (0)
+#define LOCK_R(x)	do { LOCK_SITE(x, x##_lock_site_r); (x).lock(LOCK_TYPE_READ, &x##_lock_site_r); } while (0)
+#define LOCK_W(x)	do { LOCK_SITE(x, x##_lock_site_w); (x).lock(LOCK_TYPE_WRITE, &x##_lock_site_w); } while (0)
 #define UNLOCK(x)	(x).unlock()
 #endif
 
+/* call site of a lock, it is constant-initialized and costs nothing until contended */
+class lock_site {
+public:
+	constexpr lock_site(const char *_expr, const char *_file, int _line)
+	: expr(_expr)
+	, file(_file)
+	, line(_line)
+	, contended(0)
+	, sampled(0)
+	, wait(0)
+	, max_wait(0)
+	, registered(false)
+	, next(nullptr)
+	{}
+
+	const char *expr;
+	const char *file;
+	int line;
+
+	std::atomic<uint64_t> contended;
+	std::atomic<uint64_t> sampled;
+	std::atomic<uint64_t> wait;
+	std::atomic<uint64_t> max_wait;
+
+	std::atomic<bool> registered;
+	lock_site *next;
+};
+
+/* sampled contention profiler, disabled while the sampling rate is 0 */
+class lock_profiler {
+public:
+	static void set_sampling_rate(unsigned int rate);
+	static unsigned int get_sampling_rate(void)
+	{
+		return m_sampling_rate.load(std::memory_order_relaxed);
+	}
+
+	static void get_stats(std::string &stats);
+
+private:
+	friend class cbase_lock;
+
+	static void add_site(lock_site *site);
+
+	static std::atomic<unsigned int> m_sampling_rate;
+	static std::atomic<lock_site *> m_sites;
+};
+
 class cbase_lock {
 public:
 	cbase_lock();
 	virtual ~cbase_lock();
 
 	void lock(lock_type type, const char* expr, const char *module, const char *func, int line);
+	void lock(lock_type type, lock_site *site);
 	void lock(lock_type type);
 	void unlock(void);
 
@@ -72,6 +125,9 @@ protected:
 
 	virtual int unlock_impl(void);
 private:
+	int try_lock(lock_type type);
+	void lock_contended(lock_type type, lock_site *site);
+
 	pthread_mutex_t m_history_mutex;
 	static const int OWNER_INFO_LEN = 256;
 	char m_owner_info[OWNER_INFO_LEN];
@@ -82,6 +138,7 @@ private:
 	cbase_lock& m_lock;
 public:
 	Autolock(cbase_lock &m, lock_type type, const char* expr, const char *module, const char *func, int line);
+	Autolock(cbase_lock &m, lock_type type, lock_site *site);
 	Autolock(cbase_lock &m, lock_type type);
 	~Autolock();
 };
@@ -26,8 +26,10 @@
 
 #include "sensor_log.h"
 #include "channel_event_handler.h"
+#include "flight_recorder.h"
 
 #define SYSTEMD_SOCK_BUF_SIZE (128*1024)
+#define DEFAULT_SEND_LIMIT 128
 
 using namespace ipc;
 using namespace sensor;
@@ -35,9 +37,8 @@ using namespace sensor;
 class send_event_handler : public event_handler
 {
 public:
-	send_event_handler(channel *ch, std::shared_ptr<message> msg)
+	send_event_handler(channel *ch)
 	: m_ch(ch)
-	, m_msg(msg)
 	{ }
 
 	virtual ~send_event_handler()
@@ -53,26 +54,17 @@ public:
 			return false;
 		}
 
-		m_ch->remove_pending_event_id(m_event_id);
-
-		if (!m_ch->is_connected()) {
-			return false;
-		}
-
-		if (condition & (EVENT_IN | EVENT_HUP)) {
-			return false;
-		}
-
-		if (!m_ch->send_sync(*m_msg)) {
+		if (!m_ch->is_connected() || (condition & (EVENT_IN | EVENT_HUP))) {
+			m_ch->clear_send_queue();
 			return false;
 		}
 
-		return false;
+		/* stays registered as long as messages are queued */
+		return m_ch->flush_send_queue();
 	}
 
 private:
 	channel *m_ch;
-	std::shared_ptr<message> m_msg;
 };
 
 class read_event_handler : public event_handler
@@ -116,6 +108,10 @@ channel::channel(socket *sock)
 , m_socket(sock)
 , m_handler(NULL)
 , m_loop(NULL)
+, m_send_event_id(0)
+, m_send_policy(SEND_POLICY_DROP_OLDEST)
+, m_send_limit(DEFAULT_SEND_LIMIT)
+, m_dropped(0)
 , m_connected(false)
 {
 	_D("Create[%p]", this);
@@ -193,8 +189,12 @@ void channel::disconnect(void)
 		m_handler = NULL;
 	}
 
+	clear_send_queue();
+
 	if (m_loop) {
-		for(auto id : m_pending_event_id) {
+		/* handlers remove their own ids when they are released */
+		std::vector<uint64_t> pending(m_pending_event_id);
+		for(auto id : pending) {
 			_D("Remove channel[%p] pending event id[%llu]", this, id);
 			m_loop->remove_event(id);
 		}
@@ -213,34 +213,156 @@ void channel::disconnect(void)
 
 bool channel::send(std::shared_ptr<message> msg)
 {
-	int retry_cnt = 0;
-	int cur_buffer_size = 0;
+	retv_if(!m_loop || !msg, false);
+	retv_if(!is_connected(), false);
 
-	retv_if(!m_loop, false);
+	bool idle;
+	{
+		AUTOLOCK(m_send_lock);
+		idle = m_send_queue.empty() && !m_send_event_id;
+	}
 
-	while (retry_cnt < 3) {
-		cur_buffer_size = m_socket->get_current_buffer_size();
-		if (cur_buffer_size <= SYSTEMD_SOCK_BUF_SIZE)
-			break;
-		usleep(3000);
-		retry_cnt++;
+	/* nothing is waiting and the socket has room, so write it now
+	 * instead of a loop iteration later, keeping the callers' order */
+	if (idle && m_socket->get_current_buffer_size() + msg->size() <= SYSTEMD_SOCK_BUF_SIZE)
+		return send_sync(*msg);
+
+	AUTOLOCK(m_send_lock);
+
+	if (m_send_policy == SEND_POLICY_LATEST_ONLY) {
+		/* only the newest message of each type is worth sending */
+		auto it = m_send_queue.begin();
+		while (it != m_send_queue.end()) {
+			if ((*it)->type() == msg->type()) {
+				it = m_send_queue.erase(it);
+				count_drop(msg->type());
+			} else {
+				++it;
+			}
+		}
 	}
-	retvm_if(retry_cnt >= 3, false, "Socket buffer[%d] is exceeded", cur_buffer_size);
 
-	send_event_handler *handler = new(std::nothrow) send_event_handler(this, msg);
-	retvm_if(!handler, false, "Failed to allocate memory");
+	if (m_send_queue.size() >= m_send_limit) {
+		count_drop(msg->type());
+		if (m_send_policy == SEND_POLICY_DROP_NEWEST)
+			return false;
+		m_send_queue.pop_front();
+	}
+
+	m_send_queue.push_back(msg);
+
+	if (m_send_event_id)
+		return true;
+
+	send_event_handler *handler = new(std::nothrow) send_event_handler(this);
+	if (!handler) {
+		_E("Failed to allocate memory");
+		m_send_queue.pop_back();
+		return false;
+	}
 
 	uint64_t event_id = m_loop->add_event(m_socket->get_fd(), (EVENT_OUT | EVENT_HUP | EVENT_NVAL), handler);
 	if (event_id == 0) {
 		_D("Failed to add send event handler");
 		delete handler;
+		m_send_queue.pop_back();
 		return false;
 	}
 
+	m_send_event_id = event_id;
 	m_pending_event_id.push_back(event_id);
 	return true;
 }
 
+bool channel::flush_send_queue(void)
+{
+	bool writable = true;
+
+	while (true) {
+		std::shared_ptr<message> msg;
+		{
+			AUTOLOCK(m_send_lock);
+			if (m_send_queue.empty()) {
+				m_send_event_id = 0;
+				break;
+			}
+
+			/* the socket was writable for the first message only,
+			 * the others wait for the next wakeup if the buffer is filling up */
+			if (!writable && m_socket->get_current_buffer_size() +
+					m_send_queue.front()->size() > SYSTEMD_SOCK_BUF_SIZE)
+				return true;
+
+			msg = m_send_queue.front();
+			m_send_queue.pop_front();
+		}
+
+		writable = false;
+
+		if (!send_sync(*msg)) {
+			clear_send_queue();
+			return false;
+		}
+	}
+
+	/* out of the send lock, the handler may send again */
+	if (m_handler)
+		m_handler->drained(this);
+
+	return false;
+}
+
+void channel::clear_send_queue(void)
+{
+	AUTOLOCK(m_send_lock);
+	m_send_queue.clear();
+	m_send_event_id = 0;
+}
+
+void channel::set_send_policy(int policy)
+{
+	AUTOLOCK(m_send_lock);
+	m_send_policy = policy;
+}
+
+int channel::get_send_policy(void)
+{
+	return m_send_policy;
+}
+
+void channel::set_send_limit(unsigned int limit)
+{
+	AUTOLOCK(m_send_lock);
+	m_send_limit = limit > 0 ? limit : 1;
+
+	while (m_send_queue.size() > m_send_limit) {
+		count_drop(m_send_queue.front()->type());
+		m_send_queue.pop_front();
+	}
+}
+
+unsigned int channel::get_send_limit(void)
+{
+	return m_send_limit;
+}
+
+size_t channel::get_send_queue_size(void)
+{
+	AUTOLOCK(m_send_lock);
+	return m_send_queue.size();
+}
+
+uint64_t channel::get_dropped_count(void)
+{
+	return m_dropped.load();
+}
+
+void channel::count_drop(uint32_t type)
+{
+	uint64_t dropped = ++m_dropped;
+	flight_recorder::record(FLIGHT_RECORD_DROP, get_fd(), dropped, type);
+}
+
 bool channel::send_sync(message &msg)
 {
 	AUTOLOCK(m_cmutex);
@@ -22,6 +22,7 @@
 
 #include <unistd.h>
 #include <atomic>
+#include <deque>
 #include <vector>
 
 #include "socket.h"
@@ -34,6 +35,13 @@ namespace ipc {
 
 class channel_handler;
 
+/* what send() does when the outbound queue is full */
+enum send_policy {
+	SEND_POLICY_DROP_OLDEST = 0,
+	SEND_POLICY_DROP_NEWEST,
+	SEND_POLICY_LATEST_ONLY,
+};
+
 class channel {
 public:
 	/* move owernership of the socket to the channel */
@@ -51,6 +59,16 @@ public:
 	bool send(std::shared_ptr<message> msg);
 	bool send_sync(message &msg);
 
+	/* outbound queue of send(), drained whenever the socket is writable */
+	void set_send_policy(int policy);
+	int get_send_policy(void);
+	void set_send_limit(unsigned int limit);
+	unsigned int get_send_limit(void);
+	size_t get_send_queue_size(void);
+	uint64_t get_dropped_count(void);
+	bool flush_send_queue(void);
+	void clear_send_queue(void);
+
 	bool read(void);
 	bool read_sync(message &msg, bool select = true);
 
@@ -66,6 +84,8 @@ public:
 	}
 
 private:
+	void count_drop(uint32_t type);
+
 	int m_fd;
 	uint64_t m_event_id;
 	socket *m_socket;
@@ -73,6 +93,14 @@ private:
 	event_loop *m_loop;
 	std::vector<uint64_t> m_pending_event_id;
 
+	std::deque<std::shared_ptr<message>> m_send_queue;
+	uint64_t m_send_event_id;
+	int m_send_policy;
+	unsigned int m_send_limit;
+	/* read by stats without the send lock */
+	std::atomic<uint64_t> m_dropped;
+	sensor::cmutex m_send_lock;
+
 	std::atomic<bool> m_connected;
 	sensor::cmutex m_cmutex;
 };
@@ -91,3 +91,9 @@ void channel_event_handler::error_caught(channel *ch, int error)
 	if (m_handler)
 		m_handler->error_caught(ch, error);
 }
+
+void channel_event_handler::drained(channel *ch)
+{
+	if (m_handler)
+		m_handler->drained(ch);
+}
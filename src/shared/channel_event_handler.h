@@ -41,6 +41,7 @@ public:
 	void read(channel *ch, message &msg);
 	void read_complete(channel *ch);
 	void error_caught(channel *ch, int error);
+	void drained(channel *ch);
 
 	void set_handler(int num, channel_handler* handler) {}
 	void disconnect(void) {}
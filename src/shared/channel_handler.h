@@ -37,6 +37,9 @@ public:
 	virtual void read_complete(channel *ch) = 0;
 	virtual void error_caught(channel *ch, int error) = 0;
 	virtual void set_handler(int num, channel_handler* handler) = 0;
+
+	/* the outbound queue of ch has been written out */
+	virtual void drained(channel *ch) {}
 };
 
 }
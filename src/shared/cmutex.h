@@ -28,6 +28,8 @@ public:
 	cmutex();
 	virtual ~cmutex();
 
+	using cbase_lock::lock;
+
 	void lock(void);
 	void lock(const char* expr, const char *module, const char *func, int line);
 	int try_lock(void);
@@ -38,6 +38,8 @@ enum cmd_type_e {
 	CMD_MANAGER_SENSOR_REMOVED,
 	CMD_MANAGER_SET_ATTR_INT,
 	CMD_MANAGER_GET_ATTR_INT,
+	CMD_MANAGER_GET_STATS,
+	CMD_MANAGER_SNAPSHOT,
 
 	/* Listener */
 	CMD_LISTENER_EVENT = 0x200,
@@ -52,6 +54,8 @@ enum cmd_type_e {
 	CMD_LISTENER_GET_ATTR_STR,
 	CMD_LISTENER_GET_DATA_LIST,
 	CMD_LISTENER_CONNECTED,
+	CMD_LISTENER_GROUP_CONNECT,
+	CMD_LISTENER_GROUP_EVENT,
 
 	/* Provider */
 	CMD_PROVIDER_CONNECT = 0x300,
@@ -78,11 +82,45 @@ typedef struct {
 	char sensor[NAME_MAX];
 } cmd_manager_attr_int_t;
 
+typedef struct {
+	int type;
+	int len;
+	char stats[0];
+} cmd_manager_stats_t;
+
+#define MAX_SNAPSHOT_COUNT 64
+
+typedef struct {
+	int listener_id;
+	int err;
+	sensor_data_t data;
+} cmd_manager_snapshot_entry_t;
+
+typedef struct {
+	int count;
+	cmd_manager_snapshot_entry_t entries[0];
+} cmd_manager_snapshot_t;
+
 typedef struct {
 	int listener_id;
 	char sensor[NAME_MAX];
 } cmd_listener_connect_t;
 
+#define MAX_GROUP_MEMBERS 16
+
+typedef struct {
+	int group_id;
+	int window;
+	int count;
+	int listener_id[MAX_GROUP_MEMBERS];
+	int sensor_id[MAX_GROUP_MEMBERS];
+} cmd_listener_group_connect_t;
+
+typedef struct {
+	int sensor_id;
+	sensor_data_t data;
+} cmd_listener_group_event_t;
+
 typedef struct {
 	int listener_id;
 } cmd_listener_start_t;
@@ -104,6 +142,9 @@ typedef struct {
 	char value[0];
 } cmd_listener_attr_str_t;
 
+/* change notifications may carry several string records, each padded to 4 bytes */
+#define ATTR_STR_RECORD_SIZE(len) ((sizeof(cmd_listener_attr_str_t) + (len) + 3) & ~(size_t)3)
+
 typedef struct {
 	int listener_id;
 	int len;
@@ -114,6 +155,8 @@ typedef struct {
 	int listener_id;
 	int len;
 	int data_count;
+	unsigned long long start_time; /* both 0 for the samples of the last event */
+	unsigned long long end_time;
 	sensor_data_t data[0];
 } cmd_listener_get_data_list_t;
 
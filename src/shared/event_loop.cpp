@@ -20,12 +20,21 @@
 #include "event_loop.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+#include <errno.h>
 #include <unistd.h>
 #include <time.h>
+#include <signal.h>
+#include <execinfo.h>
 #include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <cxxabi.h>
 #include <glib.h>
 
+#include <typeinfo>
+
 #include <vector>
 #include <queue>
 
@@ -33,8 +42,20 @@
 #include "sensor_log.h"
 #include "event_handler.h"
 #include "channel.h"
+#include "timer_wheel.h"
 
 #define BAD_HANDLE 0
+#define PROFILE_LINE_SIZE 256
+#define PROFILE_IDLE "idle_callback"
+#define WATCHDOG_SIGNAL (SIGRTMIN + 1)
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+static const uint64_t profile_bounds[EVENT_PROFILE_BUCKETS - 1] = {
+	100, 500, 1000, 5000, 10000, 50000, 100000
+};
 
 using namespace ipc;
 using namespace sensor;
@@ -92,9 +113,23 @@ static gboolean g_io_handler(GIOChannel *ch, GIOCondition condition, gpointer da
 	if (cond & G_IO_NVAL)
 		return G_SOURCE_REMOVE;
 
+	loop->count_dispatch(info);
+
+	/* handler could be released in handle(), so get its type in advance */
+	const char *type = NULL;
+	gint64 start = 0;
+
+	if (loop->is_profiling()) {
+		type = typeid(*handler).name();
+		start = g_get_monotonic_time();
+	}
+
 	void *addr = NULL;
 	ret = handler->handle(fd, (event_condition)cond, &addr);
 
+	if (type)
+		loop->profile(type, fd, g_get_monotonic_time() - start);
+
 	if (!ret && !term) {
 		LOCK(release_lock);
 		channel_release_queue.push((channel*)addr);
@@ -111,6 +146,65 @@ static gboolean g_io_handler(GIOChannel *ch, GIOCondition condition, gpointer da
 	return ret;
 }
 
+static std::string demangle(const char *type)
+{
+	int status;
+	char *name = abi::__cxa_demangle(type, NULL, NULL, &status);
+	retv_if(!name, type);
+
+	std::string str(name);
+	free(name);
+
+	return str;
+}
+
+static void add_sample(dispatch_stat &stat, uint64_t elapsed)
+{
+	int i;
+
+	for (i = 0; i < EVENT_PROFILE_BUCKETS - 1; ++i) {
+		if (elapsed < profile_bounds[i])
+			break;
+	}
+
+	stat.histogram[i]++;
+	stat.count++;
+	stat.total += elapsed;
+	if (stat.max < elapsed)
+		stat.max = elapsed;
+}
+
+/* the highest priority source, so that it is prepared and checked in every iteration */
+struct iteration_source {
+	GSource source;
+	event_loop *loop;
+};
+
+static gboolean iteration_prepare(GSource *src, gint *timeout)
+{
+	*timeout = -1;
+	((iteration_source *)src)->loop->end_iteration();
+	return FALSE;
+}
+
+static gboolean iteration_check(GSource *src)
+{
+	((iteration_source *)src)->loop->begin_iteration();
+	return FALSE;
+}
+
+static gboolean iteration_dispatch(GSource *src, GSourceFunc callback, gpointer data)
+{
+	return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs iteration_funcs = {
+	iteration_prepare,
+	iteration_check,
+	iteration_dispatch,
+	NULL,
+};
+
 static gint on_timer(gpointer data)
 {
 	event_loop *loop = (event_loop *)data;
@@ -125,6 +219,18 @@ event_loop::event_loop()
 , m_terminating(false)
 , m_sequence(1)
 , m_term_fd(-1)
+, m_prioritized_used(0)
+, m_prioritized_yielded(false)
+, m_stall_threshold(0)
+, m_iteration_src(NULL)
+, m_iteration_start(0)
+, m_slowest_type(NULL)
+, m_slowest_fd(-1)
+, m_slowest_elapsed(0)
+, m_watchdog_created(false)
+, m_stall_depth(0)
+, m_timer_slack(TIMER_WHEEL_DEFAULT_SLACK)
+, m_timer_wheel(NULL)
 {
 	m_mainloop = g_main_loop_new(NULL, FALSE);
 }
@@ -135,12 +241,29 @@ event_loop::event_loop(GMainLoop *mainloop)
 , m_terminating(false)
 , m_sequence(1)
 , m_term_fd(-1)
+, m_prioritized_used(0)
+, m_prioritized_yielded(false)
+, m_stall_threshold(0)
+, m_iteration_src(NULL)
+, m_iteration_start(0)
+, m_slowest_type(NULL)
+, m_slowest_fd(-1)
+, m_slowest_elapsed(0)
+, m_watchdog_created(false)
+, m_stall_depth(0)
+, m_timer_slack(TIMER_WHEEL_DEFAULT_SLACK)
+, m_timer_wheel(NULL)
 {
 	m_mainloop = mainloop;
 }
 
 event_loop::~event_loop()
 {
+	stop_watchdog();
+
+	delete m_timer_wheel;
+	m_timer_wheel = NULL;
+
 	if (m_term_fd != -1)
 		close(m_term_fd);
 
@@ -154,7 +277,8 @@ void event_loop::set_mainloop(GMainLoop *mainloop)
 	m_mainloop = mainloop;
 }
 
-uint64_t event_loop::add_event(const int fd, const event_condition cond, event_handler *handler)
+uint64_t event_loop::add_event(const int fd, const event_condition cond, event_handler *handler,
+		int priority, unsigned int budget)
 {
 	AUTOLOCK(m_cmutex);
 	GIOChannel *ch = NULL;
@@ -181,11 +305,17 @@ uint64_t event_loop::add_event(const int fd, const event_condition cond, event_h
 	handler_info *info = new(std::nothrow) handler_info(id, fd, ch, src, handler, this);
 	retvm_if(!info, BAD_HANDLE, "Failed to allocate memory");
 
+	info->priority = priority;
+	info->budget = budget;
+
 	handler->set_event_id(id);
+	g_source_set_priority(src, priority);
 	g_source_set_callback(src, (GSourceFunc) g_io_handler, info, NULL);
 	g_source_attach(src, g_main_loop_get_context(m_mainloop));
 
 	m_handlers[id] = info;
+	if (priority < EVENT_PRIORITY_DEFAULT && budget != EVENT_BUDGET_UNLIMITED)
+		m_budgeted.insert(info);
 
 	/* _D("Added event[%llu], fd[%d]", id, fd); */
 	return id;
@@ -194,9 +324,10 @@ uint64_t event_loop::add_event(const int fd, const event_condition cond, event_h
 struct idler_data {
 	void (*m_fn)(size_t, void*);
 	void* m_data;
+	event_loop *m_loop;
 };
 
-size_t event_loop::add_idle_event(unsigned int priority, void (*fn)(size_t, void*), void* data)
+size_t event_loop::add_idle_event(int priority, void (*fn)(size_t, void*), void* data)
 {
 	AUTOLOCK(m_cmutex);
 	GSource *src;
@@ -207,13 +338,24 @@ size_t event_loop::add_idle_event(unsigned int priority, void (*fn)(size_t, void
 	src = g_idle_source_new();
 	retvm_if(!src, 0, "Failed to allocate memory");
 
+	g_source_set_priority(src, priority);
+
 	idler_data *id = new idler_data();
 	id->m_fn = fn;
 	id->m_data = data;
+	id->m_loop = this;
 
 	g_source_set_callback(src, [](gpointer gdata) -> gboolean {
 		idler_data *id = (idler_data *)gdata;
+		gint64 start = 0;
+
+		if (id->m_loop->is_profiling())
+			start = g_get_monotonic_time();
+
 		id->m_fn((size_t)id, id->m_data);
+
+		if (start)
+			id->m_loop->profile(PROFILE_IDLE, -1, g_get_monotonic_time() - start);
 		delete id;
 		return G_SOURCE_REMOVE;
 	}, id, NULL);
@@ -230,6 +372,7 @@ bool event_loop::remove_event(uint64_t id)
 	auto it = m_handlers.find(id);
 	retv_if(it == m_handlers.end(), false);
 
+	m_budgeted.erase(it->second);
 	release_info(it->second);
 	m_handlers.erase(id);
 
@@ -245,6 +388,7 @@ void event_loop::remove_all_events(void)
 		release_info(it->second);
 		it = m_handlers.erase(it);
 	}
+	m_budgeted.clear();
 }
 
 void event_loop::release_info(handler_info *info)
@@ -315,6 +459,16 @@ bool event_loop::run(int timeout)
 
 	add_event(m_term_fd, EVENT_IN | EVENT_HUP | EVENT_NVAL, handler);
 
+	if (is_profiling()) {
+		m_iteration_src = g_source_new(&iteration_funcs, sizeof(iteration_source));
+		((iteration_source *)m_iteration_src)->loop = this;
+		g_source_set_priority(m_iteration_src, EVENT_PRIORITY_HIGH - 1);
+		g_source_attach(m_iteration_src, g_main_loop_get_context(m_mainloop));
+
+		if (!start_watchdog())
+			_W("Stalls will be logged without backtraces");
+	}
+
 	m_running.store(true);
 
 	_I("Started");
@@ -334,6 +488,14 @@ void event_loop::terminate(void)
 {
 	remove_all_events();
 
+	if (m_iteration_src) {
+		g_source_destroy(m_iteration_src);
+		g_source_unref(m_iteration_src);
+		m_iteration_src = NULL;
+	}
+
+	stop_watchdog();
+
 	if (m_mainloop) {
 		g_main_loop_quit(m_mainloop);
 		g_main_loop_unref(m_mainloop);
@@ -355,3 +517,235 @@ bool event_loop::is_terminator(int fd)
 {
 	return (m_term_fd == fd);
 }
+
+/*
+ * Prioritized sources(e.g. HAL events) share one budget as a class. Once they
+ * have been dispatched [budget] times in a row, all of them yield one turn to
+ * the default priority sources(e.g. client commands), so that busy HALs cannot
+ * starve clients by taking turns. A lower priority dispatch, or the turn taken
+ * by a yielded source, starts the row over. Only called from the loop thread.
+ */
+void event_loop::count_dispatch(handler_info *info)
+{
+	if (info->priority >= EVENT_PRIORITY_DEFAULT || info->yielded) {
+		m_prioritized_used = 0;
+		if (m_prioritized_yielded)
+			set_prioritized_yielded(false);
+		return;
+	}
+
+	ret_if(info->budget == EVENT_BUDGET_UNLIMITED);
+
+	if (++m_prioritized_used >= info->budget) {
+		m_prioritized_used = 0;
+		set_prioritized_yielded(true);
+	}
+}
+
+void event_loop::set_prioritized_yielded(bool yielded)
+{
+	AUTOLOCK(m_cmutex);
+
+	for (auto &info : m_budgeted) {
+		g_source_set_priority(info->g_src, yielded ? EVENT_PRIORITY_DEFAULT : info->priority);
+		info->yielded = yielded;
+	}
+
+	m_prioritized_yielded = yielded;
+}
+
+void event_loop::set_stall_threshold(unsigned int threshold)
+{
+	m_stall_threshold.store(threshold);
+	m_profile.clear();
+	m_iteration_stat = dispatch_stat();
+
+	_I("Stall threshold : %ums", threshold);
+}
+
+bool event_loop::is_profiling(void)
+{
+	return (m_stall_threshold.load() != 0);
+}
+
+void event_loop::profile(const char *type, int fd, uint64_t elapsed)
+{
+	add_sample(m_profile[type], elapsed);
+
+	if (m_slowest_elapsed < elapsed) {
+		m_slowest_type = type;
+		m_slowest_fd = fd;
+		m_slowest_elapsed = elapsed;
+	}
+}
+
+void event_loop::begin_iteration(void)
+{
+	unsigned int threshold = m_stall_threshold.load();
+	ret_if(!threshold);
+
+	m_iteration_start = g_get_monotonic_time();
+	m_slowest_type = NULL;
+	m_slowest_fd = -1;
+	m_slowest_elapsed = 0;
+	m_stall_depth = 0;
+
+	if (m_watchdog_created) {
+		struct itimerspec spec = {{0, 0}, {threshold / 1000, (threshold % 1000) * 1000000}};
+		timer_settime(m_watchdog, 0, &spec, NULL);
+	}
+}
+
+void event_loop::end_iteration(void)
+{
+	ret_if(!m_iteration_start);
+
+	uint64_t elapsed = g_get_monotonic_time() - m_iteration_start;
+	unsigned int threshold = m_stall_threshold.load();
+	m_iteration_start = 0;
+
+	if (m_watchdog_created) {
+		struct itimerspec spec = {{0, 0}, {0, 0}};
+		timer_settime(m_watchdog, 0, &spec, NULL);
+	}
+
+	add_sample(m_iteration_stat, elapsed);
+	ret_if(!threshold || elapsed < (uint64_t)threshold * 1000);
+
+	if (m_slowest_type) {
+		_W("Loop stalled for %lluus in an iteration, the slowest dispatch took %lluus by [%s] fd[%d]",
+				(unsigned long long)elapsed, (unsigned long long)m_slowest_elapsed,
+				demangle(m_slowest_type).c_str(), m_slowest_fd);
+	} else {
+		_W("Loop stalled for %lluus in an iteration", (unsigned long long)elapsed);
+	}
+
+	int depth = m_stall_depth;
+	ret_if(depth <= 0);
+
+	char **symbols = backtrace_symbols(m_stall_frames, depth);
+	ret_if(!symbols);
+
+	for (int i = 0; i < depth; ++i)
+		_W("  #%d %s", i, symbols[i]);
+
+	free(symbols);
+}
+
+/* runs on the stalled loop thread, backtrace() is safe here once libgcc has been loaded */
+void event_loop::on_watchdog(int signo, siginfo_t *info, void *context)
+{
+	event_loop *loop = (event_loop *)info->si_value.sival_ptr;
+	ret_if(!loop);
+
+	loop->m_stall_depth = backtrace(loop->m_stall_frames, EVENT_STALL_FRAMES);
+}
+
+bool event_loop::start_watchdog(void)
+{
+	static bool installed = false;
+	struct sigevent sev;
+
+	retv_if(m_watchdog_created, true);
+
+	if (!installed) {
+		struct sigaction sa;
+
+		/* the first backtrace() loads libgcc, which must not happen in the signal handler */
+		backtrace(m_stall_frames, EVENT_STALL_FRAMES);
+
+		memset(&sa, 0, sizeof(sa));
+		sa.sa_sigaction = on_watchdog;
+		sa.sa_flags = SA_SIGINFO | SA_RESTART;
+		sigemptyset(&sa.sa_mask);
+		retvm_if(sigaction(WATCHDOG_SIGNAL, &sa, NULL) < 0, false, "Failed to install the watchdog handler");
+
+		installed = true;
+	}
+
+	memset(&sev, 0, sizeof(sev));
+	sev.sigev_notify = SIGEV_THREAD_ID;
+	sev.sigev_signo = WATCHDOG_SIGNAL;
+	sev.sigev_value.sival_ptr = this;
+	sev.sigev_notify_thread_id = syscall(SYS_gettid);
+
+	if (timer_create(CLOCK_MONOTONIC, &sev, &m_watchdog) < 0) {
+		_ERRNO(errno, _E, "Failed to create the watchdog timer");
+		return false;
+	}
+
+	m_watchdog_created = true;
+	return true;
+}
+
+void event_loop::stop_watchdog(void)
+{
+	ret_if(!m_watchdog_created);
+
+	timer_delete(m_watchdog);
+	m_watchdog_created = false;
+}
+
+void event_loop::get_profile(std::string &stats)
+{
+	char line[PROFILE_LINE_SIZE];
+
+	snprintf(line, sizeof(line), "stall threshold : %ums\n", m_stall_threshold.load());
+	stats.append(line);
+
+	if (!is_profiling())
+		return;
+
+	stats.append("handler count avg(us) max(us) <100us <500us <1ms <5ms <10ms <50ms <100ms >=100ms\n");
+
+	std::vector<std::pair<std::string, dispatch_stat *>> rows;
+
+	if (m_iteration_stat.count)
+		rows.push_back(std::make_pair(std::string("iteration"), &m_iteration_stat));
+
+	for (auto &it : m_profile)
+		rows.push_back(std::make_pair(demangle(it.first), &it.second));
+
+	for (auto &it : rows) {
+		dispatch_stat &stat = *it.second;
+
+		snprintf(line, sizeof(line), "%s %llu %llu %llu",
+				it.first.c_str(),
+				(unsigned long long)stat.count,
+				(unsigned long long)(stat.total / stat.count),
+				(unsigned long long)stat.max);
+		stats.append(line);
+
+		for (int i = 0; i < EVENT_PROFILE_BUCKETS; ++i) {
+			snprintf(line, sizeof(line), " %llu", (unsigned long long)stat.histogram[i]);
+			stats.append(line);
+		}
+		stats.append("\n");
+	}
+}
+
+void event_loop::set_timer_slack(unsigned int slack)
+{
+	AUTOLOCK(m_cmutex);
+
+	retm_if(m_timer_wheel, "Timer wheel is already created");
+	m_timer_slack = slack;
+}
+
+timer_wheel *event_loop::get_timer_wheel(void)
+{
+	AUTOLOCK(m_cmutex);
+
+	if (m_timer_wheel)
+		return m_timer_wheel;
+
+	m_timer_wheel = new(std::nothrow) timer_wheel(m_timer_slack);
+	retvm_if(!m_timer_wheel, NULL, "Failed to allocate memory");
+
+	if (!m_timer_wheel->attach(this)) {
+		delete m_timer_wheel;
+		m_timer_wheel = NULL;
+	}
+
+	return m_timer_wheel;
+}
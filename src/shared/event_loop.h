@@ -21,9 +21,13 @@
 #define __EVENT_LOOP_H__
 
 #include <stdint.h>
+#include <signal.h>
+#include <time.h>
 #include <glib.h>
 #include <atomic>
 #include <map>
+#include <string>
+#include <unordered_set>
 
 #include "event_handler.h"
 #include "cmutex.h"
@@ -32,6 +36,7 @@ namespace ipc {
 
 class channel;
 class channel_handler;
+class timer_wheel;
 
 enum event_condition_e {
 	EVENT_IN =  G_IO_IN,
@@ -40,6 +45,36 @@ enum event_condition_e {
 	EVENT_NVAL = G_IO_NVAL,
 };
 
+/* sources with a higher priority are dispatched first in each iteration */
+enum event_priority_e {
+	EVENT_PRIORITY_HIGH = G_PRIORITY_HIGH,
+	EVENT_PRIORITY_DEFAULT = G_PRIORITY_DEFAULT,
+};
+
+/* budget 0 means a source may preempt lower priority sources forever */
+#define EVENT_BUDGET_UNLIMITED 0
+
+/* frames captured from a stalled loop iteration */
+#define EVENT_STALL_FRAMES 32
+
+/* dispatch time histogram buckets : <100us, <500us, <1ms, <5ms, <10ms, <50ms, <100ms, >=100ms */
+#define EVENT_PROFILE_BUCKETS 8
+
+class dispatch_stat {
+public:
+	dispatch_stat()
+	: count(0)
+	, total(0)
+	, max(0)
+	, histogram{0, }
+	{}
+
+	uint64_t count;
+	uint64_t total;
+	uint64_t max;
+	uint64_t histogram[EVENT_PROFILE_BUCKETS];
+};
+
 /* move it to file */
 class idle_handler {
 	virtual ~idle_handler();
@@ -57,6 +92,9 @@ public:
 	, g_src(_src)
 	, handler(_handler)
 	, loop(_loop)
+	, priority(EVENT_PRIORITY_DEFAULT)
+	, budget(EVENT_BUDGET_UNLIMITED)
+	, yielded(false)
 	{}
 
 	uint64_t id;
@@ -65,6 +103,10 @@ public:
 	GSource *g_src;
 	event_handler *handler;
 	event_loop *loop;
+
+	int priority;
+	unsigned int budget;
+	bool yielded;
 };
 
 class event_loop {
@@ -78,8 +120,10 @@ public:
 
 	void set_mainloop(GMainLoop *mainloop);
 
-	uint64_t add_event(const int fd, const event_condition cond, event_handler *handler);
-	size_t add_idle_event(unsigned int priority, void (*fn)(size_t, void*), void* data);
+	uint64_t add_event(const int fd, const event_condition cond, event_handler *handler,
+			int priority = EVENT_PRIORITY_DEFAULT, unsigned int budget = EVENT_BUDGET_UNLIMITED);
+	/* unlike a plain glib idle source, it runs at [priority], so busy sources cannot starve it */
+	size_t add_idle_event(int priority, void (*fn)(size_t, void*), void* data);
 
 	bool remove_event(uint64_t id);
 	void remove_all_events(void);
@@ -95,7 +139,32 @@ public:
 	bool is_running(void);
 	bool is_terminator(int fd);
 
+	/* charges a dispatch of [info] to the budget of its priority class */
+	void count_dispatch(handler_info *info);
+
+	/* dispatch and iteration profiling is enabled while the stall threshold(ms) is not 0,
+	 * it takes effect on run(), and the profile is only touched from the loop thread(or before it runs), so it is not locked */
+	void set_stall_threshold(unsigned int threshold);
+	bool is_profiling(void);
+	void profile(const char *type, int fd, uint64_t elapsed);
+	void get_profile(std::string &stats);
+
+	/* an iteration runs from the end of polling to the next prepare, one taking longer than
+	 * the stall threshold is logged with the backtrace of the loop thread at the threshold */
+	void begin_iteration(void);
+	void end_iteration(void);
+
+	/* timers of this loop share a single timerfd, slack(ms) is applied on creation */
+	void set_timer_slack(unsigned int slack);
+	timer_wheel *get_timer_wheel(void);
+
 private:
+	void set_prioritized_yielded(bool yielded);
+
+	bool start_watchdog(void);
+	void stop_watchdog(void);
+	static void on_watchdog(int signo, siginfo_t *info, void *context);
+
 	GMainLoop *m_mainloop;
 	std::atomic<bool> m_running;
 	std::atomic<bool> m_terminating;
@@ -104,6 +173,32 @@ private:
 
 	int m_term_fd;
 	sensor::cmutex m_cmutex;
+
+	/* prioritized sources with a budget, and the dispatches charged to them in a row */
+	std::unordered_set<handler_info *> m_budgeted;
+	unsigned int m_prioritized_used;
+	bool m_prioritized_yielded;
+
+	std::atomic<unsigned int> m_stall_threshold;
+	/* {handler type, stat} */
+	std::map<const char *, dispatch_stat> m_profile;
+
+	/* the current iteration, only touched from the loop thread */
+	GSource *m_iteration_src;
+	gint64 m_iteration_start;
+	dispatch_stat m_iteration_stat;
+	const char *m_slowest_type;
+	int m_slowest_fd;
+	uint64_t m_slowest_elapsed;
+
+	/* fires on the loop thread once an iteration exceeds the threshold */
+	timer_t m_watchdog;
+	bool m_watchdog_created;
+	void *m_stall_frames[EVENT_STALL_FRAMES];
+	volatile sig_atomic_t m_stall_depth;
+
+	unsigned int m_timer_slack;
+	timer_wheel *m_timer_wheel;
 };
 
 }
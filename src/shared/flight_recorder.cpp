@@ -0,0 +1,176 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "flight_recorder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <new>
+
+#include "sensor_log.h"
+#include "sensor_utils.h"
+
+using namespace sensor;
+
+flight_record_t *flight_recorder::m_ring = NULL;
+size_t flight_recorder::m_capacity = 0;
+std::atomic<uint64_t> flight_recorder::m_next(0);
+std::string flight_recorder::m_path(FLIGHT_RECORDER_PATH);
+
+void flight_recorder::set_capacity(size_t records)
+{
+	delete [] m_ring;
+	m_ring = NULL;
+	m_capacity = 0;
+	m_next.store(0);
+
+	ret_if(records == 0);
+
+	m_ring = new(std::nothrow) flight_record_t[records];
+	retm_if(!m_ring, "Failed to allocate memory");
+
+	memset(m_ring, 0, records * sizeof(flight_record_t));
+	m_capacity = records;
+
+	_I("Flight recorder keeps %zu records", records);
+}
+
+size_t flight_recorder::get_capacity(void)
+{
+	return m_capacity;
+}
+
+void flight_recorder::record(uint32_t type, int32_t id, int64_t a, int64_t b)
+{
+	if (!m_capacity)
+		return;
+
+	uint64_t seq = m_next.fetch_add(1, std::memory_order_relaxed);
+	flight_record_t &r = m_ring[seq % m_capacity];
+
+	r.time = utils::get_timestamp();
+	r.type = type;
+	r.id = id;
+	r.a = a;
+	r.b = b;
+}
+
+void flight_recorder::set_path(const char *path)
+{
+	ret_if(!path || !*path);
+
+	m_path = path;
+}
+
+std::string flight_recorder::get_path(void)
+{
+	return m_path;
+}
+
+bool flight_recorder::dump(size_t *count)
+{
+	const char *path = m_path.c_str();
+
+	retvm_if(!m_capacity, false, "Flight recorder is disabled");
+
+	uint64_t next = m_next.load();
+	uint64_t first = next > m_capacity ? next - m_capacity : 0;
+
+	flight_recorder_header_t header;
+	header.magic = FLIGHT_RECORDER_MAGIC;
+	header.version = FLIGHT_RECORDER_VERSION;
+	header.record_size = sizeof(flight_record_t);
+	header.count = next - first;
+	header.time = utils::get_timestamp();
+
+	/* Anyone may plant a file or a symlink at the path, so a new file is
+	 * created exclusively (0600) next to it and then renamed over it.
+	 * rename() replaces a symlink instead of following it. */
+	std::string temp = m_path + ".XXXXXX";
+	int fd = mkstemp(&temp[0]);
+	retvm_if(fd < 0, false, "Failed to create a file next to %s", path);
+
+	FILE *fp = fdopen(fd, "wb");
+	if (!fp) {
+		_E("Failed to open %s", temp.c_str());
+		close(fd);
+		unlink(temp.c_str());
+		return false;
+	}
+
+	bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+
+	/* the ring wraps, so write the older part first */
+	size_t start = first % m_capacity;
+	size_t head = start + header.count > m_capacity ? m_capacity - start : header.count;
+
+	if (ok && head)
+		ok = fwrite(&m_ring[start], sizeof(flight_record_t), head, fp) == head;
+	if (ok && header.count > head)
+		ok = fwrite(m_ring, sizeof(flight_record_t), header.count - head, fp) == header.count - head;
+
+	if (fclose(fp) != 0)
+		ok = false;
+
+	if (ok && rename(temp.c_str(), path) != 0)
+		ok = false;
+
+	if (!ok) {
+		_E("Failed to write %s", path);
+		unlink(temp.c_str());
+		return false;
+	}
+
+	if (count)
+		*count = header.count;
+
+	_I("Dumped %u records to %s", header.count, path);
+
+	return true;
+}
+
+bool flight_recorder::load(const char *path, std::vector<flight_record_t> &records)
+{
+	flight_recorder_header_t header;
+
+	retvm_if(!path, false, "Invalid path");
+
+	FILE *fp = fopen(path, "rb");
+	retvm_if(!fp, false, "Failed to open %s", path);
+
+	if (fread(&header, sizeof(header), 1, fp) != 1 ||
+			header.magic != FLIGHT_RECORDER_MAGIC ||
+			header.version != FLIGHT_RECORDER_VERSION ||
+			header.record_size != sizeof(flight_record_t)) {
+		_E("%s is not a flight record", path);
+		fclose(fp);
+		return false;
+	}
+
+	records.resize(header.count);
+	size_t read = header.count ? fread(records.data(), sizeof(flight_record_t), header.count, fp) : 0;
+	fclose(fp);
+
+	/* a truncated dump still holds the records before the cut */
+	records.resize(read);
+
+	return true;
+}
@@ -0,0 +1,89 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __FLIGHT_RECORDER_H__
+#define __FLIGHT_RECORDER_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#define FLIGHT_RECORDER_MAGIC 0x52464e53 /* "SNFR" */
+#define FLIGHT_RECORDER_VERSION 1
+/* a directory only sensord can write, see RuntimeDirectory of sensord.service */
+#define FLIGHT_RECORDER_PATH "/run/sensord/flight.bin"
+
+namespace sensor {
+
+enum flight_record_type_e {
+	FLIGHT_RECORD_SAMPLE = 1,  /* id: sensor, a: newest timestamp, b: samples */
+	FLIGHT_RECORD_DELIVERY,    /* id: listener, a: newest timestamp, b: samples */
+	FLIGHT_RECORD_DROP,        /* id: channel fd, a: dropped so far, b: message type */
+	FLIGHT_RECORD_COMMAND,     /* id: command, a: elapsed us, b: result */
+	FLIGHT_RECORD_CONNECT,     /* id: listener, a: channel fd, b: sensor */
+};
+
+typedef struct {
+	uint64_t time; /* monotonic, us */
+	uint32_t type;
+	int32_t id;
+	int64_t a;
+	int64_t b;
+} flight_record_t;
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t record_size;
+	uint32_t count;
+	uint64_t time; /* monotonic time of the dump, us */
+} flight_recorder_header_t;
+
+/*
+ * Fixed size ring of binary records of what the server did recently.
+ * Recording only copies a few integers into the next slot, nothing is
+ * formatted until the ring is dumped. Disabled while the capacity is 0.
+ */
+class flight_recorder {
+public:
+	/* not safe against concurrent recording, set it before the loop runs */
+	static void set_capacity(size_t records);
+	static size_t get_capacity(void);
+
+	static void record(uint32_t type, int32_t id, int64_t a, int64_t b);
+
+	static void set_path(const char *path);
+	static std::string get_path(void);
+
+	/* writes the records oldest first to the path */
+	static bool dump(size_t *count = NULL);
+	static bool load(const char *path, std::vector<flight_record_t> &records);
+
+private:
+	static flight_record_t *m_ring;
+	static size_t m_capacity;
+	static std::atomic<uint64_t> m_next;
+	static std::string m_path;
+};
+
+}
+
+#endif /* __FLIGHT_RECORDER_H__ */
@@ -91,6 +91,19 @@ void message::enclose(const void *msg, const size_t sz)
 	m_header.length = sz;
 }
 
+void message::append(const void *msg, const size_t sz)
+{
+	if (!msg || sz == 0)
+		return;
+
+	if (m_capacity < m_size + sz)
+		return;
+
+	::memcpy(m_msg + m_size, msg, sz);
+	m_size += sz;
+	m_header.length = m_size;
+}
+
 void message::enclose(int error)
 {
 	m_header.err = error;
@@ -54,6 +54,7 @@ public:
 
 	void enclose(const void *msg, const size_t size);
 	void enclose(int error);
+	void append(const void *msg, const size_t size);
 	void disclose(void *msg, const size_t size);
 
 	uint32_t type(void);
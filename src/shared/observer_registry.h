@@ -0,0 +1,129 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __OBSERVER_REGISTRY_H__
+#define __OBSERVER_REGISTRY_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <algorithm>
+
+namespace sensor {
+
+/*
+ * Contiguous list of observers that may be changed while it is walked.
+ * A walk only visits the entries present when it started. Entries removed
+ * meanwhile are left as holes and compacted once the outermost walk is
+ * over. Every change bumps the generation, so a caller can tell whether
+ * the list changed across a walk.
+ */
+template <typename T>
+class observer_registry {
+public:
+	observer_registry()
+	: m_count(0)
+	, m_generation(0)
+	, m_depth(0)
+	, m_holes(false)
+	{ }
+
+	bool add(T *ob)
+	{
+		if (!ob || contains(ob))
+			return false;
+
+		m_observers.push_back(ob);
+		m_count++;
+		m_generation++;
+		return true;
+	}
+
+	bool remove(T *ob)
+	{
+		if (!ob)
+			return false;
+
+		auto it = std::find(m_observers.begin(), m_observers.end(), ob);
+		if (it == m_observers.end())
+			return false;
+
+		if (m_depth > 0) {
+			*it = NULL;
+			m_holes = true;
+		} else {
+			m_observers.erase(it);
+		}
+
+		m_count--;
+		m_generation++;
+		return true;
+	}
+
+	bool contains(T *ob) const
+	{
+		return ob && std::find(m_observers.begin(), m_observers.end(), ob) != m_observers.end();
+	}
+
+	size_t size(void) const
+	{
+		return m_count;
+	}
+
+	uint64_t get_generation(void) const
+	{
+		return m_generation;
+	}
+
+	template <typename F>
+	void for_each(F func)
+	{
+		/* indices stay valid if an add grows the vector during the walk */
+		size_t end = m_observers.size();
+
+		m_depth++;
+		for (size_t i = 0; i < end; ++i) {
+			T *ob = m_observers[i];
+			if (ob)
+				func(ob);
+		}
+		m_depth--;
+
+		if (m_depth == 0 && m_holes)
+			compact();
+	}
+
+private:
+	void compact(void)
+	{
+		m_observers.erase(std::remove(m_observers.begin(), m_observers.end(), (T *)NULL),
+				m_observers.end());
+		m_holes = false;
+	}
+
+	std::vector<T *> m_observers;
+	size_t m_count;
+	uint64_t m_generation;
+	int m_depth;
+	bool m_holes;
+};
+
+}
+
+#endif /* __OBSERVER_REGISTRY_H__ */
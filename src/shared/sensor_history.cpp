@@ -0,0 +1,178 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "sensor_history.h"
+
+#include <string.h>
+#include <new>
+
+#include "sensor_log.h"
+
+using namespace sensor;
+
+/*
+ * A slot holding position pos has the sequence 2 * (pos + 1) once written,
+ * and an odd one while the writer is inside it.
+ */
+#define SLOT_SEQ(pos) (((pos) + 1) << 1)
+
+size_t sensor_history::m_default_depth = SENSOR_HISTORY_DEFAULT_DEPTH;
+
+sensor_history::sensor_history(size_t depth)
+: m_depth(depth ? depth : m_default_depth)
+, m_slots(NULL)
+, m_head(0)
+{
+	m_slots = new(std::nothrow) slot[m_depth];
+	if (!m_slots) {
+		_E("Failed to allocate memory");
+		m_depth = 0;
+		return;
+	}
+
+	for (size_t i = 0; i < m_depth; ++i)
+		m_slots[i].seq.store(0, std::memory_order_relaxed);
+}
+
+sensor_history::~sensor_history()
+{
+	delete [] m_slots;
+	m_slots = NULL;
+}
+
+void sensor_history::set_default_depth(size_t depth)
+{
+	ret_if(depth == 0);
+	m_default_depth = depth;
+}
+
+size_t sensor_history::get_default_depth(void)
+{
+	return m_default_depth;
+}
+
+void sensor_history::push(const sensor_data_t *data, int count)
+{
+	ret_if(m_depth == 0);
+
+	uint64_t pos = m_head.load(std::memory_order_relaxed);
+
+	for (int i = 0; i < count; ++i, ++pos) {
+		slot &s = m_slots[pos % m_depth];
+
+		s.seq.store(SLOT_SEQ(pos) - 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		memcpy(&s.data, &data[i], sizeof(sensor_data_t));
+		s.seq.store(SLOT_SEQ(pos), std::memory_order_release);
+	}
+
+	m_head.store(pos, std::memory_order_release);
+}
+
+void sensor_history::clear(void)
+{
+	/* older positions are ignored by readers from now on */
+	for (size_t i = 0; i < m_depth; ++i)
+		m_slots[i].seq.store(0, std::memory_order_release);
+}
+
+size_t sensor_history::get_depth(void)
+{
+	return m_depth;
+}
+
+uint64_t sensor_history::get_position(void)
+{
+	return m_head.load(std::memory_order_acquire);
+}
+
+bool sensor_history::read(uint64_t pos, sensor_data_t *data)
+{
+	slot &s = m_slots[pos % m_depth];
+
+	uint64_t seq = s.seq.load(std::memory_order_acquire);
+	retv_if(seq != SLOT_SEQ(pos), false);
+
+	memcpy(data, &s.data, sizeof(sensor_data_t));
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	return s.seq.load(std::memory_order_relaxed) == seq;
+}
+
+/* copies the last count samples, oldest first, and returns how many were copied */
+int sensor_history::get_latest(sensor_data_t *data, int count)
+{
+	retv_if(m_depth == 0 || count <= 0, 0);
+
+	uint64_t head = get_position();
+	uint64_t n = count;
+
+	if (n > head)
+		n = head;
+	if (n > m_depth)
+		n = m_depth;
+
+	int copied = 0;
+	for (uint64_t pos = head - n; pos < head; ++pos) {
+		if (read(pos, &data[copied]))
+			copied++;
+	}
+
+	return copied;
+}
+
+/*
+ * copies the samples with start_time <= timestamp <= end_time, oldest first.
+ * end_time 0 means up to now. If more than count match, the newest are kept.
+ */
+int sensor_history::get_range(unsigned long long start_time, unsigned long long end_time,
+		sensor_data_t *data, int count)
+{
+	retv_if(m_depth == 0 || count <= 0, 0);
+
+	uint64_t head = get_position();
+	uint64_t tail = head > m_depth ? head - m_depth : 0;
+	uint64_t pos = head;
+	sensor_data_t sample;
+	int found = 0;
+
+	/* walk back from the newest sample to find where the range starts */
+	while (pos > tail && found < count) {
+		if (!read(pos - 1, &sample))
+			break;
+		if (sample.timestamp < start_time)
+			break;
+		if (!end_time || sample.timestamp <= end_time)
+			found++;
+		pos--;
+	}
+
+	int copied = 0;
+	for (; pos < head && copied < found; ++pos) {
+		if (!read(pos, &sample))
+			continue;
+		if (sample.timestamp < start_time)
+			continue;
+		if (end_time && sample.timestamp > end_time)
+			continue;
+		memcpy(&data[copied++], &sample, sizeof(sensor_data_t));
+	}
+
+	return copied;
+}
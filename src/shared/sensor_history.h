@@ -0,0 +1,72 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __SENSOR_HISTORY_H__
+#define __SENSOR_HISTORY_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <sensor_types.h>
+
+namespace sensor {
+
+#define SENSOR_HISTORY_DEFAULT_DEPTH 64
+
+/*
+ * Fixed-capacity ring of the latest samples of a sensor.
+ * There is a single writer; every slot carries its own sequence number,
+ * so readers never block it and just skip slots overwritten under them.
+ */
+class sensor_history {
+public:
+	sensor_history(size_t depth = 0);
+	~sensor_history();
+
+	static void set_default_depth(size_t depth);
+	static size_t get_default_depth(void);
+
+	void push(const sensor_data_t *data, int count);
+	void clear(void);
+
+	size_t get_depth(void);
+	uint64_t get_position(void);
+
+	int get_latest(sensor_data_t *data, int count);
+	int get_range(unsigned long long start_time, unsigned long long end_time,
+			sensor_data_t *data, int count);
+
+private:
+	class slot {
+	public:
+		std::atomic<uint64_t> seq;
+		sensor_data_t data;
+	};
+
+	bool read(uint64_t pos, sensor_data_t *data);
+
+	static size_t m_default_depth;
+
+	size_t m_depth;
+	slot *m_slots;
+	std::atomic<uint64_t> m_head;
+};
+
+}
+
+#endif /* __SENSOR_HISTORY_H__ */
@@ -0,0 +1,189 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "thread_policy.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#include <string>
+#include <vector>
+
+#include "sensor_log.h"
+#include "sensor_utils.h"
+
+#define THREAD_NAME_MAX 16
+
+using namespace sensor;
+
+thread_policy::thread_policy()
+: m_has_cpus(false)
+, m_has_nice(false)
+, m_nice(0)
+, m_has_scheduler(false)
+, m_scheduler(SCHED_OTHER)
+, m_priority(0)
+{
+	CPU_ZERO(&m_cpus);
+}
+
+bool thread_policy::parse(const char *policy)
+{
+	retv_if(!policy, false);
+
+	std::vector<std::string> tokens = utils::tokenize(policy, ";");
+
+	for (auto &token : tokens) {
+		size_t pos = token.find('=');
+		retvm_if(pos == std::string::npos, false, "Invalid thread policy[%s]", token.c_str());
+
+		std::string key = token.substr(0, pos);
+		std::string value = token.substr(pos + 1);
+
+		if (key == "cpus") {
+			retv_if(!set_cpus(value.c_str()), false);
+		} else if (key == "nice") {
+			set_nice(atoi(value.c_str()));
+		} else if (key == "scheduler") {
+			retv_if(!set_scheduler(value.c_str()), false);
+		} else if (key == "priority") {
+			set_priority(atoi(value.c_str()));
+		} else {
+			_E("Unknown thread policy[%s]", key.c_str());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* cpus : list of cpu numbers and ranges, e.g. "0,2-3" */
+bool thread_policy::set_cpus(const char *cpus)
+{
+	cpu_set_t set;
+	char *end;
+
+	retv_if(!cpus, false);
+
+	CPU_ZERO(&set);
+
+	std::vector<std::string> tokens = utils::tokenize(cpus, ",");
+	retvm_if(tokens.empty(), false, "Invalid cpus[%s]", cpus);
+
+	for (auto &token : tokens) {
+		long first = strtol(token.c_str(), &end, 10);
+		long last = first;
+
+		if (*end == '-')
+			last = strtol(end + 1, &end, 10);
+
+		retvm_if(*end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE,
+				false, "Invalid cpus[%s]", cpus);
+
+		for (long cpu = first; cpu <= last; ++cpu)
+			CPU_SET(cpu, &set);
+	}
+
+	m_cpus = set;
+	m_has_cpus = true;
+
+	return true;
+}
+
+void thread_policy::set_nice(int nice)
+{
+	m_nice = nice;
+	m_has_nice = true;
+}
+
+bool thread_policy::set_scheduler(const char *scheduler)
+{
+	retv_if(!scheduler, false);
+
+	if (!strcmp(scheduler, "other"))
+		m_scheduler = SCHED_OTHER;
+	else if (!strcmp(scheduler, "fifo"))
+		m_scheduler = SCHED_FIFO;
+	else if (!strcmp(scheduler, "rr"))
+		m_scheduler = SCHED_RR;
+	else {
+		_E("Invalid scheduler[%s]", scheduler);
+		return false;
+	}
+
+	m_has_scheduler = true;
+
+	return true;
+}
+
+void thread_policy::set_priority(int priority)
+{
+	m_priority = priority;
+}
+
+int thread_policy::apply(const char *name)
+{
+	int err = OP_SUCCESS;
+	int ret;
+
+	if (name) {
+		char thread_name[THREAD_NAME_MAX] = {0, };
+		strncpy(thread_name, name, THREAD_NAME_MAX - 1);
+
+		ret = pthread_setname_np(pthread_self(), thread_name);
+		warn_if(ret != 0, "Failed to set thread name[%s] : %d", thread_name, ret);
+	}
+
+	if (m_has_cpus) {
+		ret = pthread_setaffinity_np(pthread_self(), sizeof(m_cpus), &m_cpus);
+		if (ret != 0) {
+			_E("Failed to set cpu affinity of [%s] : %d", name, ret);
+			err = -ret;
+		}
+	}
+
+	if (m_has_nice) {
+		if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), m_nice) < 0) {
+			err = -errno;
+			_ERRNO(errno, _E, "Failed to set nice value(%d) of [%s]", m_nice, name);
+		}
+	}
+
+	if (m_has_scheduler) {
+		struct sched_param param = {0, };
+
+		/* SCHED_OTHER only accepts the static priority 0 */
+		if (m_scheduler != SCHED_OTHER)
+			param.sched_priority = m_priority;
+
+		ret = pthread_setschedparam(pthread_self(), m_scheduler, &param);
+		if (ret != 0) {
+			_E("Failed to set scheduler(%d, %d) of [%s] : %d", m_scheduler, m_priority, name, ret);
+			err = -ret;
+		}
+	}
+
+	_I("Applied thread policy of [%s]", name);
+
+	return err;
+}
@@ -0,0 +1,57 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __THREAD_POLICY_H__
+#define __THREAD_POLICY_H__
+
+#include <sched.h>
+
+namespace sensor {
+
+/*
+ * CPU affinity, nice value and scheduling policy of a thread role.
+ * e.g. "cpus=2-3;nice=-5;scheduler=fifo;priority=10"
+ */
+class thread_policy {
+public:
+	thread_policy();
+
+	bool parse(const char *policy);
+
+	bool set_cpus(const char *cpus);
+	void set_nice(int nice);
+	bool set_scheduler(const char *scheduler);
+	void set_priority(int priority);
+
+	/* apply to the calling thread and name it */
+	int apply(const char *name);
+
+private:
+	bool m_has_cpus;
+	cpu_set_t m_cpus;
+	bool m_has_nice;
+	int m_nice;
+	bool m_has_scheduler;
+	int m_scheduler;
+	int m_priority;
+};
+
+}
+
+#endif /* __THREAD_POLICY_H__ */
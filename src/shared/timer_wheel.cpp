@@ -0,0 +1,362 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "timer_wheel.h"
+
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/timerfd.h>
+
+#include "sensor_log.h"
+
+using namespace ipc;
+
+#define LEVEL_SHIFT(level) (TIMER_WHEEL_SLOT_BITS * (level))
+#define SLOT_INDEX(tick, level) (((tick) >> LEVEL_SHIFT(level)) & (TIMER_WHEEL_SLOTS - 1))
+#define MAX_TIMER_TICKS ((1ULL << LEVEL_SHIFT(TIMER_WHEEL_LEVELS)) - 1)
+#define PROFILE_TIMER "timer_callback"
+
+class timer_event_handler : public event_handler
+{
+public:
+	timer_event_handler(timer_wheel *wheel)
+	: m_wheel(wheel)
+	{ }
+
+	bool handle(int fd, event_condition condition, void **data)
+	{
+		m_wheel->expire();
+		return true;
+	}
+
+private:
+	timer_wheel *m_wheel;
+};
+
+timer_wheel::timer_wheel(unsigned int slack)
+: m_slack(slack ? slack : 1)
+, m_fd(-1)
+, m_loop(NULL)
+, m_event_id(0)
+, m_current(0)
+, m_armed(0)
+, m_sequence(1)
+, m_wakeups(0)
+{
+	m_current = get_current_tick();
+}
+
+timer_wheel::~timer_wheel()
+{
+	detach();
+
+	for (auto &it : m_timers)
+		delete it.second;
+
+	m_timers.clear();
+}
+
+bool timer_wheel::attach(event_loop *loop)
+{
+	retvm_if(!loop, false, "Invalid event loop");
+	retvm_if(m_loop, false, "Already attached");
+
+	m_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	retvm_if(m_fd < 0, false, "Failed to create timerfd");
+
+	timer_event_handler *handler = new(std::nothrow) timer_event_handler(this);
+	if (!handler) {
+		_E("Failed to allocate memory");
+		close(m_fd);
+		m_fd = -1;
+		return false;
+	}
+
+	m_event_id = loop->add_event(m_fd, (EVENT_IN | EVENT_HUP | EVENT_NVAL), handler);
+	if (m_event_id == 0) {
+		_E("Failed to add timer event handler");
+		delete handler;
+		close(m_fd);
+		m_fd = -1;
+		return false;
+	}
+
+	m_loop = loop;
+	m_armed = 0;
+	arm();
+
+	return true;
+}
+
+void timer_wheel::detach(void)
+{
+	if (m_loop) {
+		/* handler is released by event_loop */
+		m_loop->remove_event(m_event_id);
+		m_loop = NULL;
+		m_event_id = 0;
+	}
+
+	if (m_fd >= 0) {
+		close(m_fd);
+		m_fd = -1;
+	}
+}
+
+uint64_t timer_wheel::add_timer(unsigned int timeout, bool repeat, timer_cb cb, void *data)
+{
+	retvm_if(!cb, 0, "Invalid callback");
+
+	timer *t = new(std::nothrow) timer();
+	retvm_if(!t, 0, "Failed to allocate memory");
+
+	/* round up, so that a timer never expires earlier than its timeout */
+	t->interval = (timeout + m_slack - 1) / m_slack;
+	if (t->interval == 0)
+		t->interval = 1;
+
+	/* a tick expires at its start, so the deadline is rounded up from now, not from the tick */
+	uint64_t now = get_current_ms();
+	resync(now / m_slack);
+
+	t->id = m_sequence++;
+	t->expires = (now + timeout + m_slack - 1) / m_slack;
+	t->repeat = repeat;
+	t->cb = cb;
+	t->data = data;
+	t->slot = NULL;
+
+	m_timers[t->id] = t;
+	insert(t);
+	arm();
+
+	return t->id;
+}
+
+bool timer_wheel::remove_timer(uint64_t id)
+{
+	auto it = m_timers.find(id);
+	retv_if(it == m_timers.end(), false);
+
+	timer *t = it->second;
+	m_timers.erase(it);
+
+	unlink(t);
+	delete t;
+
+	return true;
+}
+
+unsigned int timer_wheel::get_slack(void)
+{
+	return m_slack;
+}
+
+size_t timer_wheel::get_timer_count(void)
+{
+	return m_timers.size();
+}
+
+uint64_t timer_wheel::get_wakeup_count(void)
+{
+	return m_wakeups;
+}
+
+void timer_wheel::expire(void)
+{
+	uint64_t expirations;
+
+	/* it is nonblocking, so just drain it */
+	if (read(m_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN)
+		_ERRNO(errno, _E, "Failed to read timerfd[%d]", m_fd);
+
+	m_wakeups++;
+	m_armed = 0;
+
+	advance(get_current_tick());
+	arm();
+}
+
+uint64_t timer_wheel::get_current_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000;
+}
+
+uint64_t timer_wheel::get_current_tick(void)
+{
+	return get_current_ms() / m_slack;
+}
+
+void timer_wheel::resync(uint64_t tick)
+{
+	/* an empty wheel has nothing to cascade or expire,
+	 * so it jumps to [tick] instead of stepping through the idle ticks */
+	if (m_timers.empty() && tick > m_current)
+		m_current = tick;
+}
+
+void timer_wheel::insert(timer *t)
+{
+	int level;
+
+	if (t->expires < m_current)
+		t->expires = m_current;
+	if (t->expires - m_current > MAX_TIMER_TICKS)
+		t->expires = m_current + MAX_TIMER_TICKS;
+
+	uint64_t delta = t->expires - m_current;
+
+	for (level = 0; level < TIMER_WHEEL_LEVELS - 1; ++level) {
+		if (delta < (1ULL << LEVEL_SHIFT(level + 1)))
+			break;
+	}
+
+	t->slot = &m_slots[level][SLOT_INDEX(t->expires, level)];
+	t->pos = t->slot->insert(t->slot->end(), t);
+}
+
+void timer_wheel::unlink(timer *t)
+{
+	ret_if(!t->slot);
+
+	t->slot->erase(t->pos);
+	t->slot = NULL;
+}
+
+void timer_wheel::cascade(int level, int index)
+{
+	std::list<timer *> timers;
+	timers.swap(m_slots[level][index]);
+
+	for (auto &t : timers)
+		insert(t);
+}
+
+void timer_wheel::advance(uint64_t now)
+{
+	std::list<timer *> expired;
+
+	resync(now);
+
+	while (m_current <= now) {
+		int index = SLOT_INDEX(m_current, 0);
+
+		/* move timers of upper levels down when lower level wraps around */
+		for (int level = 1; index == 0 && level < TIMER_WHEEL_LEVELS; ++level) {
+			index = SLOT_INDEX(m_current, level);
+			cascade(level, index);
+		}
+
+		expired.splice(expired.end(), m_slots[0][SLOT_INDEX(m_current, 0)]);
+		for (auto it = expired.begin(); it != expired.end(); ++it)
+			(*it)->slot = &expired;
+
+		m_current++;
+
+		/* callbacks may add or remove any timer including the expired ones */
+		while (!expired.empty()) {
+			timer *t = expired.front();
+			expired.pop_front();
+			t->slot = NULL;
+
+			uint64_t id = t->id;
+			timer_cb cb = t->cb;
+			void *data = t->data;
+
+			if (t->repeat) {
+				t->expires += t->interval;
+				insert(t);
+			} else {
+				m_timers.erase(id);
+				delete t;
+			}
+
+			if (!m_loop || !m_loop->is_profiling()) {
+				cb(id, data);
+				continue;
+			}
+
+			gint64 start = g_get_monotonic_time();
+			cb(id, data);
+			m_loop->profile(PROFILE_TIMER, m_fd, g_get_monotonic_time() - start);
+		}
+	}
+}
+
+bool timer_wheel::get_next_tick(uint64_t &tick)
+{
+	bool found = false;
+
+	for (uint64_t i = 0; i < TIMER_WHEEL_SLOTS; ++i) {
+		if (!m_slots[0][SLOT_INDEX(m_current + i, 0)].empty()) {
+			tick = m_current + i;
+			found = true;
+			break;
+		}
+	}
+
+	/* timers of upper levels have to be cascaded at the start of their slot */
+	for (int level = 1; level < TIMER_WHEEL_LEVELS; ++level) {
+		uint64_t current = m_current >> LEVEL_SHIFT(level);
+
+		for (uint64_t i = 1; i <= TIMER_WHEEL_SLOTS; ++i) {
+			if (m_slots[level][SLOT_INDEX(current + i, 0)].empty())
+				continue;
+
+			uint64_t next = (current + i) << LEVEL_SHIFT(level);
+			if (!found || next < tick)
+				tick = next;
+			found = true;
+			break;
+		}
+	}
+
+	return found;
+}
+
+void timer_wheel::arm(void)
+{
+	struct itimerspec spec = {{0, 0}, {0, 0}};
+	uint64_t next;
+
+	ret_if(m_fd < 0);
+
+	if (!get_next_tick(next)) {
+		ret_if(m_armed == 0);
+		m_armed = 0;
+	} else {
+		ret_if(m_armed == next);
+		m_armed = next;
+
+		uint64_t ms = next * m_slack;
+		spec.it_value.tv_sec = ms / 1000;
+		spec.it_value.tv_nsec = (ms % 1000) * 1000000;
+
+		/* timerfd regards 0 as disarming */
+		if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+			spec.it_value.tv_nsec = 1;
+	}
+
+	if (timerfd_settime(m_fd, TFD_TIMER_ABSTIME, &spec, NULL) < 0)
+		_ERRNO(errno, _E, "Failed to set timerfd[%d]", m_fd);
+}
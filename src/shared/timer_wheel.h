@@ -0,0 +1,99 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2026 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+#include <stdint.h>
+#include <list>
+#include <unordered_map>
+
+#include "event_loop.h"
+
+namespace ipc {
+
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_SLOT_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_DEFAULT_SLACK 10 /* ms */
+
+typedef void (*timer_cb)(uint64_t id, void *data);
+
+/*
+ * Hierarchical timer wheel driven by a single timerfd.
+ * A tick is as long as the slack, so deadlines in the same tick expire
+ * together in one wakeup, never earlier than requested.
+ */
+class timer_wheel {
+public:
+	timer_wheel(unsigned int slack = TIMER_WHEEL_DEFAULT_SLACK);
+	~timer_wheel();
+
+	bool attach(event_loop *loop);
+	void detach(void);
+
+	uint64_t add_timer(unsigned int timeout, bool repeat, timer_cb cb, void *data);
+	bool remove_timer(uint64_t id);
+
+	unsigned int get_slack(void);
+	size_t get_timer_count(void);
+	uint64_t get_wakeup_count(void);
+
+	void expire(void);
+
+private:
+	class timer {
+	public:
+		uint64_t id;
+		uint64_t expires;
+		uint64_t interval;
+		bool repeat;
+		timer_cb cb;
+		void *data;
+		std::list<timer *> *slot;
+		std::list<timer *>::iterator pos;
+	};
+
+	uint64_t get_current_ms(void);
+	uint64_t get_current_tick(void);
+	void resync(uint64_t tick);
+	void insert(timer *t);
+	void unlink(timer *t);
+	void cascade(int level, int index);
+	void advance(uint64_t now);
+	bool get_next_tick(uint64_t &tick);
+	void arm(void);
+
+	unsigned int m_slack;
+	int m_fd;
+	event_loop *m_loop;
+	uint64_t m_event_id;
+
+	uint64_t m_current;
+	uint64_t m_armed;
+	uint64_t m_sequence;
+	uint64_t m_wakeups;
+
+	std::list<timer *> m_slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+	std::unordered_map<uint64_t, timer *> m_timers;
+};
+
+}
+
+#endif /* __TIMER_WHEEL_H__ */